@@ -277,6 +277,44 @@ BENCHMARK_TEMPLATE(BM_BOSS_fwd_and_pick_edge, 3) -> Unit(benchmark::kMicrosecond
 BENCHMARK_TEMPLATE(BM_BOSS_fwd_and_pick_edge, 4) -> Unit(benchmark::kMicrosecond);
 
 
+// walk random paths with fwd and pick_edge in the given representation
+template <BOSS::State STATE>
+static void BM_BOSS_traverse(benchmark::State &state) {
+    auto graph = load_graph(state);
+    graph->switch_state(STATE);
+    const BOSS &boss = graph->get_boss();
+
+    auto starts = random_numbers(NUM_DISTINCT_INDEXES, 1, boss.get_W().size() - 1);
+    auto labels = random_numbers(PATH_SIZE, 1, boss.alph_size - 1);
+
+    size_t i = 0;
+    size_t steps = 0;
+    for (auto _ : state) {
+        uint64_t edge = starts[i++ % NUM_DISTINCT_INDEXES];
+        for (size_t j = 0; j < PATH_SIZE; ++j) {
+            BOSS::TAlphabet w = boss.get_W(edge) % boss.alph_size;
+            if (!w)
+                break;
+
+            // follow the edge with a random label, or the last outgoing edge
+            uint64_t target = boss.fwd(edge, w);
+            uint64_t next = boss.pick_edge(target, labels[j]);
+            edge = next ? next : target;
+            ++steps;
+        }
+        benchmark::DoNotOptimize(edge);
+    }
+
+    state.counters["time/step"] = benchmark::Counter(
+        steps, benchmark::Counter::kIsRate | benchmark::Counter::kInvert
+    );
+}
+BENCHMARK_TEMPLATE(BM_BOSS_traverse, BOSS::State::STAT) -> Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_BOSS_traverse, BOSS::State::FAST) -> Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_BOSS_traverse, BOSS::State::SMALL) -> Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_BOSS_traverse, BOSS::State::INTERLEAVED) -> Unit(benchmark::kMicrosecond);
+
+
 DEFINE_BOSS_BENCHMARK(pred_W_$,            pred_W,              get_W,    size, 0);
 DEFINE_BOSS_BENCHMARK(pred_W_A,            pred_W,              get_W,    size, 1);
 DEFINE_BOSS_BENCHMARK(pred_W_C,            pred_W,              get_W,    size, 2);
@@ -0,0 +1,91 @@
+#include "benchmark/benchmark.h"
+
+#include <random>
+#include <vector>
+
+#include "sketch/tensor.hpp"
+
+
+namespace {
+
+typedef ts::Tensor<uint8_t> Tensor;
+
+template <typename T>
+std::vector<T> random_vector(size_t size, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<T> dis(0, 1);
+    std::vector<T> v(size);
+    for (T &x : v) {
+        x = dis(gen);
+    }
+    return v;
+}
+
+// one step of the tensor sketch recurrence with the modulo-based cyclic shift
+template <typename T, size_t embed_dim>
+static void BM_shift_sum_scalar(benchmark::State& state) {
+    auto a = random_vector<T>(embed_dim, 1);
+    auto b = random_vector<T>(embed_dim, 2);
+    uint8_t shift = 0;
+
+    for (auto _ : state) {
+        Tensor::shift_sum_inplace_scalar(a.data(), b.data(), embed_dim, shift, T(0.3));
+        benchmark::DoNotOptimize(a.data());
+        shift = (shift + 7) % embed_dim;
+    }
+}
+
+// the same step, with the cyclic shift split into two contiguous spans
+// (vectorized when compiled with AVX2)
+template <typename T, size_t embed_dim>
+static void BM_shift_sum(benchmark::State& state) {
+    auto a = random_vector<T>(embed_dim, 1);
+    auto b = random_vector<T>(embed_dim, 2);
+    uint8_t shift = 0;
+
+    for (auto _ : state) {
+        Tensor::shift_sum_inplace(a.data(), b.data(), embed_dim, shift, T(0.3));
+        benchmark::DoNotOptimize(a.data());
+        shift = (shift + 7) % embed_dim;
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_shift_sum_scalar, double, 20);
+BENCHMARK_TEMPLATE(BM_shift_sum, double, 20);
+BENCHMARK_TEMPLATE(BM_shift_sum_scalar, double, 32);
+BENCHMARK_TEMPLATE(BM_shift_sum, double, 32);
+BENCHMARK_TEMPLATE(BM_shift_sum_scalar, double, 64);
+BENCHMARK_TEMPLATE(BM_shift_sum, double, 64);
+BENCHMARK_TEMPLATE(BM_shift_sum_scalar, float, 20);
+BENCHMARK_TEMPLATE(BM_shift_sum, float, 20);
+BENCHMARK_TEMPLATE(BM_shift_sum_scalar, float, 32);
+BENCHMARK_TEMPLATE(BM_shift_sum, float, 32);
+BENCHMARK_TEMPLATE(BM_shift_sum_scalar, float, 64);
+BENCHMARK_TEMPLATE(BM_shift_sum, float, 64);
+
+
+// sketching of a single window (k = 31, window = 6) with the raw-buffer kernels
+template <size_t embed_dim>
+static void BM_tensor_compute_into(benchmark::State& state) {
+    Tensor tensor(4, embed_dim, 3, 0);
+    std::vector<double> scratch(tensor.scratch_size());
+    std::vector<double> sketch(embed_dim);
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<uint32_t> dis(0, 3);
+    std::vector<uint8_t> seq(6);
+    for (uint8_t &c : seq) {
+        c = dis(gen);
+    }
+
+    for (auto _ : state) {
+        tensor.compute_into(seq.data(), seq.size(), sketch.data(), scratch.data());
+        benchmark::DoNotOptimize(sketch.data());
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_tensor_compute_into, 20);
+BENCHMARK_TEMPLATE(BM_tensor_compute_into, 32);
+BENCHMARK_TEMPLATE(BM_tensor_compute_into, 64);
+
+} // namespace
@@ -0,0 +1,263 @@
+#include "benchmark/benchmark.h"
+
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cli/seqgen.hpp"
+#include "graph/alignment/aligner_seeder_methods.hpp"
+#include "graph/graph_extensions/sketch_index.hpp"
+#include "graph/representation/hash/dbg_hash_ordered.hpp"
+#include "sketch/tensor.hpp"
+#include "sketch/tensor_slide.hpp"
+
+
+namespace {
+
+using namespace mtg;
+using namespace mtg::graph;
+using namespace mtg::graph::align;
+
+const size_t kTupleLength = 3;
+// window length used by KmerSketcher for k = 31
+const size_t kWindow = 6;
+
+std::vector<uint8_t> random_int_sequence(size_t length, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint32_t> dis(0, 3);
+    std::vector<uint8_t> seq(length);
+    for (uint8_t &c : seq) {
+        c = dis(gen);
+    }
+    return seq;
+}
+
+// time per item (window or read), with |num_items| items processed per iteration
+benchmark::Counter time_per(size_t num_items) {
+    return benchmark::Counter(num_items, benchmark::Counter::kIsIterationInvariantRate
+                                            | benchmark::Counter::kInvert);
+}
+
+
+template <size_t embed_dim>
+static void BM_tensor_compute(benchmark::State& state) {
+    ts::Tensor<uint8_t> tensor(4, embed_dim, kTupleLength, 0);
+    auto seq = random_int_sequence(kWindow, 42);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tensor.compute(seq));
+    }
+
+    state.counters["time/window"] = time_per(1);
+}
+
+BENCHMARK_TEMPLATE(BM_tensor_compute, 20);
+BENCHMARK_TEMPLATE(BM_tensor_compute, 64);
+
+// sliding sketches of all windows of a read of length |state.range(0)|
+template <size_t embed_dim>
+static void BM_tensor_slide_compute(benchmark::State& state) {
+    ts::TensorSlide<uint8_t> tensor(4, embed_dim, kTupleLength, kWindow, 1, 0);
+    auto seq = random_int_sequence(state.range(0), 42);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tensor.compute(seq));
+    }
+
+    state.counters["time/window"] = time_per(seq.size());
+}
+
+BENCHMARK_TEMPLATE(BM_tensor_slide_compute, 20)->Arg(150)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_tensor_slide_compute, 64)->Arg(150)->Arg(1000);
+
+// the same, with the allocation-free kernel used by the sketch seeder
+template <size_t embed_dim>
+static void BM_tensor_slide_compute_windows_into(benchmark::State& state) {
+    ts::TensorSlide<uint8_t> tensor(4, embed_dim, kTupleLength, kWindow, 1, 0);
+    auto seq = random_int_sequence(state.range(0), 42);
+    std::vector<double> scratch(tensor.window_scratch_size());
+    std::vector<float> sketches((seq.size() - kWindow + 1) * embed_dim);
+
+    for (auto _ : state) {
+        tensor.compute_windows_into(seq.data(), seq.size(), sketches.data(), scratch.data());
+        benchmark::DoNotOptimize(sketches.data());
+    }
+
+    state.counters["time/window"] = time_per(seq.size() - kWindow + 1);
+}
+
+BENCHMARK_TEMPLATE(BM_tensor_slide_compute_windows_into, 20)->Arg(150)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_tensor_slide_compute_windows_into, 64)->Arg(150)->Arg(1000);
+
+
+// Seeding benchmarks on a graph of random sequences with a sketch index, queried
+// with reads sampled from the graph and mutated with cli/seqgen
+const size_t kK = 31;
+const size_t kNumReads = 100;
+
+struct SeedingData {
+    std::shared_ptr<DBGHashOrdered> graph;
+    DBGAlignerConfig config;
+};
+
+const SeedingData& get_seeding_data() {
+    static SeedingData data = []() {
+        ts::init_alphabet("dna4");
+
+        SeedingData data;
+        data.graph = std::make_shared<DBGHashOrdered>(kK);
+        std::mt19937 gen(1);
+        std::uniform_int_distribution<uint32_t> dis(0, 3);
+        for (size_t i = 0; i < 20; ++i) {
+            std::string sequence(10'000, 'A');
+            for (char &c : sequence) {
+                c = "ACGT"[dis(gen)];
+            }
+            data.graph->add_sequence(sequence);
+        }
+
+        auto &config = data.config;
+        config.score_matrix = DBGAlignerConfig::dna_scoring_matrix(2, -1, -2);
+        config.min_seed_length = kK;
+        config.max_seed_length = std::numeric_limits<size_t>::max();
+
+        SketchIndex::Params params {
+            .k = static_cast<uint32_t>(kK),
+            .kmer_word_size = config.kmer_word_size,
+            .embed_dim = config.embed_dim,
+            .tuple_length = config.tuple_length,
+            .n_times_sketch = config.n_times_sketch,
+        };
+        auto sketch_index = std::make_shared<SketchIndex>(*data.graph, params);
+        sketch_index->set_search_params(config.sketch_ef_search, config.sketch_nprobe);
+        data.graph->add_extension(sketch_index);
+
+        return data;
+    }();
+    return data;
+}
+
+struct Reads {
+    std::vector<std::string> reads;
+    // nodes of the paths from which the reads were sampled
+    std::vector<std::unordered_set<uint64_t>> true_nodes;
+    // query nodes of the reads mapped to the graph
+    std::vector<std::vector<DeBruijnGraph::node_index>> nodes;
+};
+
+// |num_reads| reads of length |read_length| with |error_rate| percent errors
+const Reads& get_reads(size_t read_length, int error_rate) {
+    static std::map<std::pair<size_t, int>, Reads> cache;
+    auto [it, inserted] = cache.try_emplace({ read_length, error_rate });
+    Reads &reads = it->second;
+    if (!inserted)
+        return reads;
+
+    const DeBruijnGraph &graph = *get_seeding_data().graph;
+    std::vector<std::string> reference_spellings;
+    std::vector<std::vector<uint64_t>> paths;
+    srand(0);
+    cli::generate_sequences(graph, read_length - kK + 1, read_length - kK + 1,
+                            kNumReads, error_rate, { 'A', 'T', 'G', 'C' },
+                            reference_spellings, reads.reads, paths);
+
+    for (size_t i = 0; i < reads.reads.size(); ++i) {
+        reads.true_nodes.emplace_back(paths[i].begin(), paths[i].end());
+        auto &nodes = reads.nodes.emplace_back();
+        graph.map_to_nodes_sequentially(reads.reads[i],
+                                        [&](auto node) { nodes.push_back(node); });
+    }
+
+    return reads;
+}
+
+// Time get_seeds for reads of length |state.range(0)| with |state.range(1)| percent
+// errors, including the construction of the seeders, and report the fraction of
+// seeded nodes lying on the path the read was sampled from (precision) and the
+// fraction of the path nodes found among the seeds (recall).
+template <class Seeder>
+static void BM_get_seeds(benchmark::State& state) {
+    const SeedingData &data = get_seeding_data();
+    const Reads &reads = get_reads(state.range(0), state.range(1));
+    const size_t num_reads = reads.reads.size();
+
+    std::vector<std::vector<Seed>> seeds(num_reads);
+    for (auto _ : state) {
+        for (size_t i = 0; i < num_reads; ++i) {
+            auto nodes = reads.nodes[i];
+            Seeder seeder(*data.graph, reads.reads[i], false, std::move(nodes), data.config);
+            seeds[i] = seeder.get_seeds();
+        }
+        benchmark::DoNotOptimize(seeds.data());
+    }
+
+    size_t num_seeded_nodes = 0;
+    size_t num_correct_nodes = 0;
+    size_t num_true_nodes = 0;
+    size_t num_found_nodes = 0;
+    for (size_t i = 0; i < num_reads; ++i) {
+        std::unordered_set<uint64_t> found;
+        for (const Seed &seed : seeds[i]) {
+            for (auto node : seed.get_nodes()) {
+                ++num_seeded_nodes;
+                if (reads.true_nodes[i].count(node)) {
+                    ++num_correct_nodes;
+                    found.insert(node);
+                }
+            }
+        }
+        num_true_nodes += reads.true_nodes[i].size();
+        num_found_nodes += found.size();
+    }
+
+    state.counters["time/read"] = time_per(num_reads);
+    state.counters["seeds/read"] = static_cast<double>(num_seeded_nodes) / num_reads;
+    state.counters["precision"] = num_seeded_nodes
+        ? static_cast<double>(num_correct_nodes) / num_seeded_nodes
+        : 0;
+    state.counters["recall"] = static_cast<double>(num_found_nodes) / num_true_nodes;
+}
+
+void seeding_args(benchmark::internal::Benchmark *b) {
+    for (int64_t read_length : { 100, 250, 1000 }) {
+        for (int64_t error_rate : { 0, 1, 5, 10 }) {
+            b->Args({ read_length, error_rate });
+        }
+    }
+    b->ArgNames({ "length", "error" })->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK_TEMPLATE(BM_get_seeds, ExactSeeder)->Apply(seeding_args);
+BENCHMARK_TEMPLATE(BM_get_seeds, UniMEMSeeder)->Apply(seeding_args);
+BENCHMARK_TEMPLATE(BM_get_seeds, SketchSeeder)->Apply(seeding_args);
+
+// the sketch index searched once for all reads, as done by the aligner for a batch
+static void BM_get_seeds_sketch_batch(benchmark::State& state) {
+    const SeedingData &data = get_seeding_data();
+    const Reads &reads = get_reads(state.range(0), state.range(1));
+    const size_t num_reads = reads.reads.size();
+
+    for (auto _ : state) {
+        std::vector<SketchSeeder> seeders;
+        seeders.reserve(num_reads);
+        std::vector<const SketchSeeder*> batch;
+        for (size_t i = 0; i < num_reads; ++i) {
+            auto nodes = reads.nodes[i];
+            batch.push_back(&seeders.emplace_back(*data.graph, reads.reads[i], false,
+                                                  std::move(nodes), data.config));
+        }
+        SketchSeeder::search_batch(batch);
+        for (const SketchSeeder &seeder : seeders) {
+            benchmark::DoNotOptimize(seeder.get_seeds());
+        }
+    }
+
+    state.counters["time/read"] = time_per(num_reads);
+}
+
+BENCHMARK(BM_get_seeds_sketch_batch)->Apply(seeding_args);
+
+} // namespace
@@ -495,6 +495,26 @@ class TestQuery(TestingBase):
         self.assertEqual(res.returncode, 0)
         self.assertEqual(len(res.stdout), 136959)
 
+    def test_batch_query_with_suffix_matches_parallel(self):
+        """The batch graph built in parallel must give the same results"""
+        if self.graph_repr != 'succinct':
+            self.skipTest('suffix matches are supported only for succinct graphs')
+
+        outputs = []
+        for num_threads in [1, NUM_THREADS]:
+            query_command = f'{METAGRAPH} query --fast --align --batch-align \
+                                --align-min-seed-length 15 --max-hull-forks 4 \
+                                -i {self.tempdir.name}/graph{graph_file_extension[self.graph_repr]} \
+                                -a {self.tempdir.name}/annotation{anno_file_extension[self.anno_repr]} \
+                                -p {num_threads} --discovery-fraction 0.0 --align-min-exact-match 0.0 \
+                                {TEST_DATA_DIR}/transcripts_100_tail10_snp.fa'
+
+            res = subprocess.run(query_command.split(), stdout=PIPE)
+            self.assertEqual(res.returncode, 0)
+            outputs.append(sorted(res.stdout.decode().split('\n')))
+
+        self.assertEqual(outputs[0], outputs[1])
+
     def test_query_coordinates(self):
         if not self.anno_repr.endswith('_coord'):
             self.skipTest('annotation does not support coordinates')
@@ -539,6 +559,27 @@ class TestQuery(TestingBase):
         self.assertEqual(res.returncode, 0)
         self.assertEqual(len(res.stdout), 492788)
 
+    def test_batch_query_coordinates(self):
+        """batch query must give the same coordinates as the basic query"""
+        if not self.anno_repr.endswith('_coord'):
+            self.skipTest('annotation does not support coordinates')
+
+        for flags in ['', '--verbose-output']:
+            for discovery_fraction in [0.05, 0.95]:
+                outputs = []
+                for fast in ['', '--fast']:
+                    query_command = f'{METAGRAPH} query --query-coords {flags} {fast} \
+                                        -i {self.tempdir.name}/graph{graph_file_extension[self.graph_repr]} \
+                                        -a {self.tempdir.name}/annotation{anno_file_extension[self.anno_repr]} \
+                                        -p {NUM_THREADS} --discovery-fraction {discovery_fraction} \
+                                        {TEST_DATA_DIR}/transcripts_100.fa'
+
+                    res = subprocess.run(query_command.split(), stdout=PIPE)
+                    self.assertEqual(res.returncode, 0)
+                    outputs.append(sorted(res.stdout.decode().split('\n')))
+
+                self.assertEqual(outputs[0], outputs[1])
+
 
 @parameterized_class(('graph_repr', 'anno_repr'),
     input_values=product(['succinct'], ANNO_TYPES),
@@ -617,6 +658,23 @@ class TestQueryTinyLinear(TestingBase):
                             '<L2>:0:1:2:3:4:5:6:7:8:9:10:11',
                             '<L3>:::::0:1:2:3::::'})
 
+    def test_batch_query_coordinates(self):
+        if not self.anno_repr.endswith('_coord'):
+            self.skipTest('annotation does not support coordinates')
+
+        query_command = f'{METAGRAPH} query --fast --query-coords  --verbose-output \
+                            -i {self.tempdir.name}/graph{graph_file_extension[self.graph_repr]} \
+                            -a {self.tempdir.name}/annotation{anno_file_extension[self.anno_repr]} \
+                            --discovery-fraction 0.05 {self.fasta_graph}'
+
+        res = subprocess.run(query_command.split(), stdout=PIPE)
+        self.assertEqual(res.returncode, 0)
+        self.assertEqual(set(res.stdout.decode().strip().split('\t')),
+                         {'0', 'L',
+                            '<L1>:0:1:2:3:4:5:6:7:8:9:10:11',
+                            '<L2>:0:1:2:3:4:5:6:7:8:9:10:11',
+                            '<L3>:::::0:1:2:3::::'})
+
 
 @parameterized_class(('graph_repr', 'anno_repr'),
     input_values=product(
@@ -1143,6 +1201,25 @@ class TestQueryCanonical(TestingBase):
         self.assertEqual(res.returncode, 0)
         self.assertEqual(len(res.stdout), 137093)
 
+    def test_batch_query_coordinates_both(self):
+        """batch query must give the same coordinates as the basic query"""
+        if not self.anno_repr.endswith('_coord'):
+            self.skipTest('annotation does not support coordinates')
+
+        outputs = []
+        for fast in ['', '--fast']:
+            query_command = f'{METAGRAPH} query --query-coords --fwd-and-reverse {fast} \
+                                -i {self.tempdir.name}/graph{graph_file_extension[self.graph_repr]} \
+                                -a {self.tempdir.name}/annotation{anno_file_extension[self.anno_repr]} \
+                                -p {NUM_THREADS} --discovery-fraction 0.05 \
+                                {TEST_DATA_DIR}/transcripts_100.fa'
+
+            res = subprocess.run(query_command.split(), stdout=PIPE)
+            self.assertEqual(res.returncode, 0)
+            outputs.append(sorted(res.stdout.decode().split('\n')))
+
+        self.assertEqual(outputs[0], outputs[1])
+
 
 @parameterized_class(('graph_repr', 'anno_repr'),
     input_values=(product(list(set(GRAPH_TYPES) - {'hashstr'}), ANNO_TYPES) +
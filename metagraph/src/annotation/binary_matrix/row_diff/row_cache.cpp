@@ -0,0 +1,95 @@
+#include "row_cache.hpp"
+
+#include <cassert>
+#include <algorithm>
+
+
+namespace mtg {
+namespace annot {
+namespace binmat {
+
+RowCache::RowCache(size_t max_bytes, size_t num_shards)
+      : max_shard_bytes_(max_bytes / std::max(num_shards, size_t(1))),
+        shards_(std::max(num_shards, size_t(1))) {}
+
+RowCache::Shard& RowCache::get_shard(Row row) {
+    // consecutive rows go to different shards
+    return shards_[((row * 0x9e3779b97f4a7c15ull) >> 32) % shards_.size()];
+}
+
+bool RowCache::get(Row row, SetBitPositions *set_bits, bool is_query) {
+    assert(set_bits);
+
+    Shard &shard = get_shard(row);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(row);
+    if (it == shard.index.end()) {
+        if (is_query)
+            misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    (is_query ? hits_ : path_hits_).fetch_add(1, std::memory_order_relaxed);
+    shard.rows.splice(shard.rows.begin(), shard.rows, it->second);
+    *set_bits = it->second->second;
+    return true;
+}
+
+void RowCache::put(Row row, const SetBitPositions &set_bits) {
+    const size_t num_bytes = row_bytes(set_bits);
+    if (num_bytes > max_shard_bytes_)
+        return;
+
+    Shard &shard = get_shard(row);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(row);
+    if (it != shard.index.end()) {
+        // the cached rows never change, so only mark it as recently used
+        shard.rows.splice(shard.rows.begin(), shard.rows, it->second);
+        return;
+    }
+
+    shard.rows.emplace_front(row, set_bits);
+    shard.index.emplace(row, shard.rows.begin());
+    shard.num_bytes += num_bytes;
+
+    // evict the least recently used rows
+    while (shard.num_bytes > max_shard_bytes_) {
+        assert(shard.rows.size() > 1);
+        shard.num_bytes -= row_bytes(shard.rows.back().second);
+        shard.index.erase(shard.rows.back().first);
+        shard.rows.pop_back();
+    }
+}
+
+void RowCache::clear() {
+    for (Shard &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.rows.clear();
+        shard.index.clear();
+        shard.num_bytes = 0;
+    }
+    hits_ = 0;
+    misses_ = 0;
+    path_hits_ = 0;
+}
+
+RowCache::Stats RowCache::get_stats() const {
+    Stats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.path_hits = path_hits_.load(std::memory_order_relaxed);
+
+    for (const Shard &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.num_rows += shard.rows.size();
+        stats.num_bytes += shard.num_bytes;
+    }
+    return stats;
+}
+
+} // namespace binmat
+} // namespace annot
+} // namespace mtg
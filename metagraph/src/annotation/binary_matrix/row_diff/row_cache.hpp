@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <vector>
+
+#include <tsl/hopscotch_map.h>
+
+#include "annotation/binary_matrix/base/binary_matrix.hpp"
+
+
+namespace mtg {
+namespace annot {
+namespace binmat {
+
+/**
+ * A thread-safe cache of fully reconstructed annotation rows, bounded by the
+ * number of bytes taken by the cached rows.
+ * The rows are distributed over shards, each with its own lock and LRU eviction
+ * policy, so that concurrent queries rarely wait for each other.
+ * Rows are keyed by their index only, so a cache must not be shared by
+ * several matrices.
+ */
+class RowCache {
+  public:
+    typedef BinaryMatrix::Row Row;
+    typedef BinaryMatrix::SetBitPositions SetBitPositions;
+
+    struct Stats {
+        // lookups of the queried rows
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        // rows on the row-diff paths of the queried rows found in the cache
+        uint64_t path_hits = 0;
+        uint64_t num_rows = 0;
+        uint64_t num_bytes = 0;
+
+        double hit_rate() const {
+            return hits + misses ? static_cast<double>(hits) / (hits + misses) : 0;
+        }
+    };
+
+    static constexpr size_t kDefaultNumShards = 64;
+
+    explicit RowCache(size_t max_bytes, size_t num_shards = kDefaultNumShards);
+
+    // If the row is cached, copy it to |set_bits| and return true.
+    // Lookups of the rows on row-diff paths are passed with |is_query| = false,
+    // so that the hits and misses are counted once per queried row.
+    bool get(Row row, SetBitPositions *set_bits, bool is_query = true);
+
+    void put(Row row, const SetBitPositions &set_bits);
+
+    void clear();
+
+    Stats get_stats() const;
+
+    size_t max_bytes() const { return max_shard_bytes_ * shards_.size(); }
+
+  private:
+    typedef std::list<std::pair<Row, SetBitPositions>> RowList;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        // the most recently used rows first
+        RowList rows;
+        tsl::hopscotch_map<Row, RowList::iterator> index;
+        size_t num_bytes = 0;
+    };
+
+    Shard& get_shard(Row row);
+
+    // approximate memory taken by a cached row
+    static size_t row_bytes(const SetBitPositions &set_bits) {
+        return set_bits.size() * sizeof(SetBitPositions::value_type)
+                + sizeof(RowList::value_type) + 4 * sizeof(void*);
+    }
+
+    size_t max_shard_bytes_;
+    std::vector<Shard> shards_;
+
+    std::atomic<uint64_t> hits_ = 0;
+    std::atomic<uint64_t> misses_ = 0;
+    std::atomic<uint64_t> path_hits_ = 0;
+};
+
+} // namespace binmat
+} // namespace annot
+} // namespace mtg
@@ -2,11 +2,13 @@
 
 #include <algorithm>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "annotation/binary_matrix/base/binary_matrix.hpp"
 #include "annotation/binary_matrix/column_sparse/column_major.hpp"
+#include "annotation/binary_matrix/row_diff/row_cache.hpp"
 #include "common/vectors/bit_vector_adaptive.hpp"
 #include "common/vector_map.hpp"
 #include "common/vector.hpp"
@@ -42,6 +44,12 @@ class IRowDiff {
 
     const anchor_bv_type& anchor() const { return anchor_; }
 
+    // Set a cache of reconstructed rows, which may be queried concurrently.
+    // The cache is keyed by row index only, so it must belong to this matrix
+    // alone. Only used for binary row-diff matrices.
+    void set_row_cache(std::shared_ptr<RowCache> row_cache) { row_cache_ = row_cache; }
+    const std::shared_ptr<RowCache>& row_cache() const { return row_cache_; }
+
   protected:
     // get row-diff paths starting at |row_ids|
     std::pair<std::vector<BinaryMatrix::Row>, std::vector<std::vector<size_t>>>
@@ -50,6 +58,7 @@ class IRowDiff {
     const graph::DBGSuccinct *graph_ = nullptr;
     anchor_bv_type anchor_;
     fork_succ_bv_type fork_succ_;
+    std::shared_ptr<RowCache> row_cache_;
 };
 
 /**
@@ -68,6 +77,8 @@ class IRowDiff {
  * annotation for  i-th row, we start traversing the node corresponding to i in #graph_
  * and accumulate the values in #diffs until we hit an anchor node, which is stored in
  * full.
+ * If a #RowCache is set, the traversal also stops at the first row found in the
+ * cache, and the reconstructed rows are added to the cache.
  */
 //NOTE: Clang aggressively abuses the clause in the C++ standard (14.7.1/11) that allows
 // virtual methods in template classes to not be instantiated if unused and mistakenly
@@ -153,7 +164,13 @@ BinaryMatrix::SetBitPositions RowDiff<BaseMatrix>::get_row(Row row) const {
     assert(anchor_.size() == diffs_.num_rows() && "anchors must be loaded");
     assert(!fork_succ_.size() || fork_succ_.size() == graph_->get_boss().get_last().size());
 
-    Vector<uint64_t> result = diffs_.get_row(row);
+    Vector<uint64_t> result;
+    if (row_cache_ && row_cache_->get(row, &result))
+        return result;
+
+    const Row query_row = row;
+
+    result = diffs_.get_row(row);
     std::sort(result.begin(), result.end());
 
     uint64_t boss_edge = graph_->kmer_to_boss_index(
@@ -167,11 +184,21 @@ BinaryMatrix::SetBitPositions RowDiff<BaseMatrix>::get_row(Row row) const {
         row = graph::AnnotatedSequenceGraph::graph_to_anno_index(
                 graph_->boss_to_kmer_index(boss_edge));
 
-        auto diff_row = diffs_.get_row(row);
+        Vector<uint64_t> diff_row;
+        // a cached row is stored in full, so the traversal stops there
+        if (row_cache_ && row_cache_->get(row, &diff_row, false)) {
+            add_diff(diff_row, &result);
+            break;
+        }
+
+        diff_row = diffs_.get_row(row);
         std::sort(diff_row.begin(), diff_row.end());
         add_diff(diff_row, &result);
     }
 
+    if (row_cache_)
+        row_cache_->put(query_row, result);
+
     return result;
 }
 
@@ -199,6 +226,9 @@ RowDiff<BaseMatrix>::get_rows(const std::vector<Row> &row_ids) const {
     // been reached before, and thus, will be reconstructed before this one.
     std::vector<std::vector<size_t>> rd_paths_trunc(row_ids.size());
 
+    // rows found in the cache, with their indexes in |rd_ids|
+    std::vector<std::pair<size_t, SetBitPositions>> cached_rows;
+
     const graph::boss::BOSS &boss = graph_->get_boss();
     const bit_vector &rd_succ = fork_succ_.size() ? fork_succ_ : boss.get_last();
 
@@ -230,14 +260,53 @@ RowDiff<BaseMatrix>::get_rows(const std::vector<Row> &row_ids) const {
             if (anchor_[row])
                 break;
 
+            // A cached row is stored in full, so it's used as if it was an anchor
+            SetBitPositions cached_row;
+            if (row_cache_ && row_cache_->get(row, &cached_row, row == row_ids[i])) {
+                cached_rows.emplace_back(rd_ids.size() - 1, std::move(cached_row));
+                break;
+            }
+
             boss_edge = boss.row_diff_successor(boss_edge, rd_succ);
         }
     }
 
     node_to_rd = VectorMap<Row, size_t>();
 
-    std::vector<SetBitPositions> rd_rows = diffs_.get_rows(rd_ids);
-    DEBUG_LOG("Queried batch of {} diffed rows", rd_ids.size());
+    std::vector<SetBitPositions> rd_rows;
+    if (cached_rows.empty()) {
+        rd_rows = diffs_.get_rows(rd_ids);
+    } else {
+        // query only the rows not found in the cache
+        std::vector<Row> diff_ids;
+        diff_ids.reserve(rd_ids.size() - cached_rows.size());
+        auto cached_it = cached_rows.begin();
+        for (size_t j = 0; j < rd_ids.size(); ++j) {
+            if (cached_it != cached_rows.end() && cached_it->first == j) {
+                ++cached_it;
+            } else {
+                diff_ids.push_back(rd_ids[j]);
+            }
+        }
+
+        std::vector<SetBitPositions> diff_rows = diffs_.get_rows(diff_ids);
+
+        rd_rows.resize(rd_ids.size());
+        cached_it = cached_rows.begin();
+        auto diff_it = diff_rows.begin();
+        for (size_t j = 0; j < rd_ids.size(); ++j) {
+            if (cached_it != cached_rows.end() && cached_it->first == j) {
+                rd_rows[j] = std::move(cached_it->second);
+                ++cached_it;
+            } else {
+                rd_rows[j] = std::move(*diff_it);
+                ++diff_it;
+            }
+        }
+        assert(diff_it == diff_rows.end());
+    }
+    DEBUG_LOG("Queried batch of {} diffed rows, {} rows found in cache",
+              rd_ids.size() - cached_rows.size(), cached_rows.size());
 
     rd_ids = std::vector<Row>();
 
@@ -262,6 +331,12 @@ RowDiff<BaseMatrix>::get_rows(const std::vector<Row> &row_ids) const {
     DEBUG_LOG("Reconstructed annotations for {} rows", rows.size());
     assert(times_traversed == std::vector<size_t>(rd_rows.size(), 0));
 
+    if (row_cache_) {
+        for (size_t i = 0; i < row_ids.size(); ++i) {
+            row_cache_->put(row_ids[i], rows[i]);
+        }
+    }
+
     return rows;
 }
 
@@ -67,6 +67,68 @@ void CSRMatrix::serialize(std::ostream &) const {
     throw std::runtime_error("Not implemented");
 }
 
+
+TupleCSRMatrix::TupleCSRMatrix(Vector<RowTuples>&& rows, uint64_t num_columns)
+      : num_columns_(num_columns), vector_(std::move(rows)) {
+    // make sure there are no columns with indexes greater than num_labels
+    assert(std::all_of(vector_.begin(), vector_.end(), [&](const auto &row) {
+        return std::all_of(row.begin(), row.end(),
+                           [num_columns](const auto &pair) { return pair.first < num_columns; });
+    }));
+}
+
+std::vector<TupleCSRMatrix::RowTuples>
+TupleCSRMatrix::get_row_tuples(const std::vector<Row> &rows) const {
+    std::vector<RowTuples> row_tuples(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        row_tuples[i] = vector_[rows[i]];
+    }
+    return row_tuples;
+}
+
+// total number of attributes in all tuples
+uint64_t TupleCSRMatrix::num_attributes() const {
+    uint64_t num_attributes = 0;
+    for (const auto &row : vector_) {
+        for (const auto &[_, tuple] : row) {
+            num_attributes += tuple.size();
+        }
+    }
+    return num_attributes;
+}
+
+// number of non-empty tuples in the matrix
+uint64_t TupleCSRMatrix::num_relations() const {
+    return std::accumulate(
+        vector_.begin(), vector_.end(), (uint64_t)0,
+        [](uint64_t sum, const auto &v) { return sum + v.size(); }
+    );
+}
+
+bool TupleCSRMatrix::get(Row row, Column column) const {
+    assert(row < vector_.size());
+    return std::find_if(vector_[row].begin(), vector_[row].end(),
+                        [&](const auto &pair) { return pair.first == column; })
+                != vector_[row].end();
+}
+
+std::vector<TupleCSRMatrix::Row> TupleCSRMatrix::get_column(Column column) const {
+    std::vector<Row> result;
+    for (uint64_t i = 0; i < vector_.size(); ++i) {
+        if (get(i, column))
+            result.push_back(i);
+    }
+    return result;
+}
+
+bool TupleCSRMatrix::load(std::istream &) {
+    throw std::runtime_error("Not implemented");
+}
+
+void TupleCSRMatrix::serialize(std::ostream &) const {
+    throw std::runtime_error("Not implemented");
+}
+
 } // namespace matrix
 } // namespace annot
 } // namespace mtg
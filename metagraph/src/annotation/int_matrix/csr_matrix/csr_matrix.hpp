@@ -44,6 +44,41 @@ class CSRMatrix : public IntMatrix {
     Vector<RowValues> vector_;
 };
 
+/**
+ * Multi-Value Compressed Sparse Row Matrix
+ *
+ * Matrix which stores the non-empty tuples in row-major order.
+ */
+class TupleCSRMatrix : public MultiIntMatrix {
+  public:
+    explicit TupleCSRMatrix(uint64_t num_rows = 0) : vector_(num_rows) {}
+
+    TupleCSRMatrix(Vector<RowTuples>&& rows, uint64_t num_columns);
+
+    uint64_t num_attributes() const;
+
+    // row is in [0, num_rows), column is in [0, num_columns)
+    RowTuples get_row_tuples(Row row) const { return vector_[row]; }
+
+    std::vector<RowTuples>
+    get_row_tuples(const std::vector<Row> &rows) const;
+
+    uint64_t num_columns() const { return num_columns_; }
+    uint64_t num_rows() const { return vector_.size(); }
+    uint64_t num_relations() const;
+
+    // row is in [0, num_rows), column is in [0, num_columns)
+    bool get(Row row, Column column) const;
+    std::vector<Row> get_column(Column column) const;
+
+    bool load(std::istream &in);
+    void serialize(std::ostream &out) const;
+
+  private:
+    uint64_t num_columns_ = 0;
+    Vector<RowTuples> vector_;
+};
+
 } // namespace matrix
 } // namespace annot
 } // namespace mtg
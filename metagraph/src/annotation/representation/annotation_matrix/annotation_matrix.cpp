@@ -213,6 +213,7 @@ template class StaticBinRelAnnotator<matrix::CSCMatrix<binmat::BRWT, CountsVecto
 template class StaticBinRelAnnotator<matrix::IntRowDiff<matrix::CSCMatrix<binmat::BRWT, CountsVector>>, std::string>;
 
 template class StaticBinRelAnnotator<matrix::CSRMatrix, std::string>;
+template class StaticBinRelAnnotator<matrix::TupleCSRMatrix, std::string>;
 
 template class StaticBinRelAnnotator<matrix::TupleCSCMatrix<binmat::ColumnMajor>, std::string>;
 template class StaticBinRelAnnotator<matrix::TupleCSCMatrix<binmat::BRWT>, std::string>;
@@ -53,6 +53,8 @@ typedef StaticBinRelAnnotator<matrix::IntRowDiff<matrix::CSCMatrix<binmat::BRWT,
 
 typedef StaticBinRelAnnotator<matrix::CSRMatrix, std::string> IntRowAnnotator;
 
+typedef StaticBinRelAnnotator<matrix::TupleCSRMatrix, std::string> TupleRowAnnotator;
+
 typedef StaticBinRelAnnotator<matrix::TupleCSCMatrix<binmat::ColumnMajor>, std::string> ColumnCoordAnnotator;
 
 typedef StaticBinRelAnnotator<matrix::TupleCSCMatrix<binmat::BRWT>, std::string> MultiBRWTCoordAnnotator;
@@ -91,6 +93,8 @@ inline const std::string IntRowDiffBRWTAnnotator::kExtension = ".row_diff_int_br
 template <>
 inline const std::string IntRowAnnotator::kExtension = ".int_csr.annodbg";
 template <>
+inline const std::string TupleRowAnnotator::kExtension = ".tuple_csr.annodbg";
+template <>
 inline const std::string ColumnCoordAnnotator::kExtension = ".column_coord.annodbg";
 template <>
 inline const std::string MultiBRWTCoordAnnotator::kExtension = ".brwt_coord.annodbg";
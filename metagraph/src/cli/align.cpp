@@ -15,6 +15,7 @@
 #include "graph/annotated_dbg.hpp"
 #include "graph/graph_extensions/node_rc.hpp"
 #include "graph/graph_extensions/node_first_cache.hpp"
+#include "graph/graph_extensions/sketch_index.hpp"
 #include "seq_io/sequence_io.hpp"
 #include "config/config.hpp"
 #include "load/load_graph.hpp"
@@ -64,7 +65,10 @@ DBGAlignerConfig initialize_aligner_config(const Config &config) {
         .m = config.m,
         .n_times_sketch = config.n_times_sketch,
         .minimizer_window = config.minimizer_window,
-        .num_neighbours = config.num_neighbours
+        .num_neighbours = config.num_neighbours,
+        .sliding_sketch = config.sliding_sketch,
+        .sketch_ef_search = config.sketch_ef_search,
+        .sketch_nprobe = config.sketch_nprobe
     };
 
     c.set_scoring_matrix();
@@ -329,6 +333,13 @@ int align_to_graph(Config *config) {
                              "Alignment speed will be significantly slower. "
                              "Use metagraph transform to generate an adj-rc index.");
             }
+
+            auto node_first = std::make_shared<NodeFirstCache>(*dbg_succ);
+            if (node_first->load(config->infbase)
+                    && node_first->is_compatible(*dbg_succ, false)) {
+                logger->trace("Loaded the index of the first characters of nodes");
+                dbg_succ->add_extension(node_first);
+            }
         }
     }
 
@@ -369,22 +380,51 @@ int align_to_graph(Config *config) {
 
     DBGAlignerConfig aligner_config = initialize_aligner_config(*config);
 
-    // compute sketches
+    // load or compute sketches
 
     if (config->seeder == "sketch") {
         aligner_config.max_num_free_indels = 6;
         aligner_config.left_end_bonus = 0;
         aligner_config.right_end_bonus = 0;
-	const char* index_saving_fname = (config->index_path).c_str();
-        graph->compute_sketches(aligner_config.kmer_word_size,
-                                aligner_config.embed_dim,
-                                aligner_config.tuple_length,
-                                aligner_config.n_times_sketch,
-                                get_num_threads(),
-				index_saving_fname,
-				config->load_index);
-        /* std::cout << "Sleeping" << std::endl; */
-        /* std::this_thread::sleep_for(std::chrono::seconds(15)); */
+
+        SketchIndex::Params params {
+            .k = static_cast<uint32_t>(graph->get_k()),
+            .kmer_word_size = aligner_config.kmer_word_size,
+            .embed_dim = aligner_config.embed_dim,
+            .tuple_length = aligner_config.tuple_length,
+            .n_times_sketch = aligner_config.n_times_sketch,
+        };
+        // the index is stored next to the graph, unless another path is given
+        const std::string index_fbase = config->index_path.size()
+                ? config->index_path
+                : utils::make_suffix(config->infbase, graph->file_extension());
+
+        auto sketch_index = std::make_shared<SketchIndex>();
+        Timer index_timer;
+        if (config->load_index && sketch_index->load(index_fbase)) {
+            if (!sketch_index->is_compatible(*graph, params)) {
+                logger->error("Sketch index {} does not match the graph or the sketching "
+                              "parameters. Rebuild it with --load-index 0", index_fbase);
+                exit(1);
+            }
+            if (sketch_index->get_index_type() != config->sketch_index_type) {
+                logger->warn("Loaded sketch index of type '{}', rebuild it with --load-index 0 "
+                             "to use type '{}'", sketch_index->get_index_type(),
+                             config->sketch_index_type);
+            }
+            logger->trace("Loaded sketch index in {} sec", index_timer.elapsed());
+        } else {
+            logger->trace("Building sketch index...");
+            sketch_index = std::make_shared<SketchIndex>(*graph, params,
+                                                         config->sketch_index_type,
+                                                         get_num_threads());
+            sketch_index->serialize(index_fbase);
+            logger->trace("Sketch index built and serialized in {} sec",
+                          index_timer.elapsed());
+        }
+        sketch_index->set_search_params(aligner_config.sketch_ef_search,
+                                        aligner_config.sketch_nprobe);
+        graph->add_extension(sketch_index);
     }
     std::unique_ptr<AnnotatedDBG> anno_dbg;
     if (config->infbase_annotators.size()) {
@@ -443,9 +483,13 @@ int align_to_graph(Config *config) {
                     aln_graph = std::make_shared<CanonicalDBG>(aln_graph);
                     logger->trace("Primary graph wrapped into canonical");
                     // If backwards traversal on DBGSuccinct will be needed, then
-                    // add a cache to speed it up.
-                    if (dbg_succ)
+                    // add a cache to speed it up, unless a precomputed index
+                    // is shared with the wrapper already.
+                    if (dbg_succ && !aln_graph->get_extension_threadsafe<NodeFirstCache>())
                         aln_graph->add_extension(std::make_shared<NodeFirstCache>(*dbg_succ));
+                    // share the sketch index with the wrapper
+                    if (auto sketch_index = graph->get_extension<SketchIndex>())
+                        aln_graph->add_extension(sketch_index);
                 }
 
                 std::unique_ptr<IDBGAligner> aligner;
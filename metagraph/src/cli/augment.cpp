@@ -10,6 +10,7 @@
 #include "common/vectors/bit_vector_dyn.hpp"
 #include "graph/representation/succinct/dbg_succinct.hpp"
 #include "graph/graph_extensions/node_weights.hpp"
+#include "graph/graph_extensions/sketch_index.hpp"
 #include "graph/annotated_dbg.hpp"
 #include "load/load_graph.hpp"
 #include "load/load_annotation.hpp"
@@ -47,24 +48,27 @@ int augment_graph(Config *config) {
         node_weights.reset();
     }
 
+    // the sketch index is updated in place, so it is loaded into memory
+    auto sketch_index = std::make_shared<graph::SketchIndex>();
+    if (!sketch_index->load(utils::make_suffix(config->infbase, graph->file_extension()),
+                            false)) {
+        sketch_index.reset();
+    } else if (!sketch_index->is_compatible(*graph)) {
+        logger->error("Sketch index is not compatible with graph '{}' "
+                      "and will not be updated", config->infbase);
+        sketch_index.reset();
+    }
+
     logger->trace("De Bruijn graph with k-mer length k={} was loaded in {} sec",
                   graph->get_k(), timer.elapsed());
     timer.reset();
 
-    if (dynamic_cast<graph::DBGSuccinct*>(graph.get())) {
-        auto &succinct_graph = dynamic_cast<graph::DBGSuccinct&>(*graph);
-
-        if (succinct_graph.get_state() != graph::boss::BOSS::State::DYN) {
-            logger->trace("Switching state of succinct graph to dynamic...");
-
-            succinct_graph.switch_state(graph::boss::BOSS::State::DYN);
-
-            logger->trace("State switching done in {} sec", timer.elapsed());
-        }
-    }
+    // the succinct graph is extended in batches merged into the BOSS table,
+    // so it does not have to be switched to the dynamic state
+    auto *succinct_graph = dynamic_cast<graph::DBGSuccinct*>(graph.get());
 
     std::unique_ptr<bit_vector_dyn> inserted_nodes;
-    if (config->infbase_annotators.size() || node_weights)
+    if (config->infbase_annotators.size() || node_weights || sketch_index)
         inserted_nodes.reset(new bit_vector_dyn(graph->max_index() + 1, 0));
 
     timer.reset();
@@ -86,18 +90,45 @@ int augment_graph(Config *config) {
     if (inserted_nodes)
         on_node_insert = [&](uint64_t new_node) { inserted_nodes->insert_bit(new_node, 1); };
 
+    // the total length of the sequences in a batch, all sequences are inserted
+    // at once if zero, since each batch is merged with the whole graph
+    const uint64_t max_batch_length = config->insert_batch_size;
+    std::vector<std::string> batch;
+    uint64_t batch_length = 0;
+
+    auto flush_batch = [&]() {
+        if (batch.empty())
+            return;
+
+        logger->trace("Merging a batch of {} sequences with total length {} into the graph",
+                      batch.size(), batch_length);
+        succinct_graph->add_sequences(std::move(batch), on_node_insert, get_num_threads());
+        batch.clear();
+        batch_length = 0;
+    };
+
+    auto add_sequence = [&](std::string_view seq) {
+        if (!succinct_graph) {
+            graph->add_sequence(seq, on_node_insert);
+            return;
+        }
+
+        batch.emplace_back(seq);
+        batch_length += seq.size();
+        if (max_batch_length && batch_length >= max_batch_length)
+            flush_batch();
+    };
+
     for (const auto &file : files) {
         parse_sequences(file, *config,
-            [&](std::string_view seq) {
-                graph->add_sequence(seq, on_node_insert);
-            },
-            [&](std::string_view seq, uint32_t /*count*/) {
-                graph->add_sequence(seq, on_node_insert);
-            }
+            [&](std::string_view seq) { add_sequence(seq); },
+            [&](std::string_view seq, uint32_t /*count*/) { add_sequence(seq); }
         );
         logger->trace("Extracted all sequences from file '{}' in {} sec",
                       file, timer.elapsed());
     }
+    flush_batch();
+
     assert(!inserted_nodes || inserted_nodes->size() == graph->max_index() + 1);
 
     logger->trace("Graph augmentation done in {} sec", timer.elapsed());
@@ -131,6 +162,16 @@ int augment_graph(Config *config) {
 
     logger->trace("Node weights updated in {} sec", timer.elapsed());
 
+    if (sketch_index) {
+        timer.reset();
+        logger->trace("Updating sketch index...");
+        // only the unitigs with new k-mers are sketched
+        ts::init_alphabet("dna4");
+        sketch_index->insert_nodes(*graph, *inserted_nodes, get_num_threads());
+        graph->add_extension(sketch_index);
+        logger->trace("Sketch index updated in {} sec", timer.elapsed());
+    }
+
     assert(config->outfbase.size());
 
     // serialize graph
@@ -7,6 +7,7 @@
 #include "graph/representation/hash/dbg_hash_ordered.hpp"
 #include "graph/representation/hash/dbg_hash_string.hpp"
 #include "graph/representation/hash/dbg_hash_fast.hpp"
+#include "graph/representation/hash/dbg_hash_mphf.hpp"
 #include "graph/representation/bitmap/dbg_bitmap.hpp"
 #include "graph/representation/bitmap/dbg_bitmap_construct.hpp"
 #include "graph/representation/succinct/dbg_succinct.hpp"
@@ -277,6 +278,16 @@ int build_graph(Config *config) {
                 graph.reset(new DBGHashFast(config->k, config->graph_mode, true));
                 break;
 
+            case Config::GraphType::HASH_MPHF:
+                if (config->count_kmers) {
+                    logger->error("Counting k-mers is not supported"
+                                  " for static hash graphs");
+                    exit(1);
+                }
+                // the static graph is indexed from a dynamic one below
+                graph.reset(new DBGHashFast(config->k, config->graph_mode, true));
+                break;
+
             case Config::GraphType::HASH_STR:
                 if (config->graph_mode != DeBruijnGraph::BASIC) {
                     logger->warn("String hash-based de Bruijn graph"
@@ -306,6 +317,15 @@ int build_graph(Config *config) {
                           file, timer.elapsed());
         }
 
+        if (config->graph_type == Config::GraphType::HASH_MPHF) {
+            logger->trace("Indexing k-mers with a minimal perfect hash...");
+            graph.reset(new DBGHashMPHF(*graph,
+                                        static_cast<uint8_t>(config->fingerprint_bits),
+                                        get_num_threads()));
+            logger->trace("Indexed {} k-mers in {} sec",
+                          graph->num_nodes(), timer.elapsed());
+        }
+
         if (config->count_kmers) {
             graph->add_extension(std::make_shared<NodeWeights>(graph->max_index() + 1,
                                                                config->count_width));
@@ -358,12 +378,9 @@ int build_graph(Config *config) {
                          static_cast<int>(63 / log2(dbg_succ->get_boss().alph_size - 1)));
 
         } else if (suffix_length) {
-            logger->trace("Index all node ranges for suffixes of length {} in {:.2f} MB",
-                          suffix_length,
-                          std::pow(dbg_succ->get_boss().alph_size - 1, suffix_length)
-                                * 2. * sizeof(uint64_t) * 1e-6);
+            logger->trace("Index node ranges for suffixes of length {}", suffix_length);
             timer.reset();
-            dbg_succ->get_boss().index_suffix_ranges(suffix_length);
+            dbg_succ->get_boss().index_suffix_ranges(suffix_length, get_num_threads());
 
             logger->trace("Indexing of node ranges took {} sec", timer.elapsed());
         }
@@ -442,12 +459,9 @@ int concatenate_graph_chunks(Config *config) {
                              static_cast<int>(63 / log2(dbg_succ->get_boss().alph_size - 1)));
 
             } else if (suffix_length) {
-                logger->trace("Index all node ranges for suffixes of length {} in {:.2f} MB",
-                              suffix_length,
-                              std::pow(dbg_succ->get_boss().alph_size - 1, suffix_length)
-                                    * 2. * sizeof(uint64_t) * 1e-6);
+                logger->trace("Index node ranges for suffixes of length {}", suffix_length);
                 timer.reset();
-                dbg_succ->get_boss().index_suffix_ranges(suffix_length);
+                dbg_succ->get_boss().index_suffix_ranges(suffix_length, get_num_threads());
 
                 logger->trace("Indexing of node ranges took {} sec", timer.elapsed());
             }
@@ -44,6 +44,8 @@ Config::Config(int argc, char *argv[]) {
         identity = CLEAN;
     } else if (!strcmp(argv[1], "merge")) {
         identity = MERGE;
+        // no limit for the input graphs loaded at once by default
+        memory_available = 0;
     } else if (!strcmp(argv[1], "extend")) {
         identity = EXTEND;
     } else if (!strcmp(argv[1], "concatenate")) {
@@ -140,6 +142,8 @@ Config::Config(int argc, char *argv[]) {
             count_kmers = true;
         } else if (!strcmp(argv[i], "--count-width")) {
             count_width = atoi(get_value(i++));
+        } else if (!strcmp(argv[i], "--fingerprint-bits")) {
+            fingerprint_bits = atoi(get_value(i++));
         } else if (!strcmp(argv[i], "--fwd-and-reverse")) {
             forward_and_reverse = true;
         } else if (!strcmp(argv[i], "--mode")) {
@@ -170,6 +174,8 @@ Config::Config(int argc, char *argv[]) {
             fast = true;
         } else if (!strcmp(argv[i], "--batch-size")) {
             query_batch_size_in_bytes = atoll(get_value(i++));
+        } else if (!strcmp(argv[i], "--insert-batch-size")) {
+            insert_batch_size = atoll(get_value(i++));
         } else if (!strcmp(argv[i], "-p") || !strcmp(argv[i], "--parallel")) {
             set_num_threads(atoi(get_value(i++)));
         } else if (!strcmp(argv[i], "--parallel-nodes")) {
@@ -359,6 +365,16 @@ Config::Config(int argc, char *argv[]) {
             embed_dim = std::stoi(get_value(i++));
         } else if (!strcmp(argv[i], "--seeder")) {
             seeder = get_value(i++);
+        } else if (!strcmp(argv[i], "--sliding-sketch")) {
+            sliding_sketch = true;
+        } else if (!strcmp(argv[i], "--sketch-index-type")) {
+            sketch_index_type = get_value(i++);
+        } else if (!strcmp(argv[i], "--sketch-ef-search")) {
+            sketch_ef_search = atoi(get_value(i++));
+        } else if (!strcmp(argv[i], "--sketch-nprobe")) {
+            sketch_nprobe = atoi(get_value(i++));
+        } else if (!strcmp(argv[i], "--sketch-stats-queries")) {
+            sketch_stats_queries = atoi(get_value(i++));
         } else if (!strcmp(argv[i], "--anno-type")) {
             anno_type = string_to_annotype(get_value(i++));
         } else if (!strcmp(argv[i], "--graph")) {
@@ -379,6 +395,8 @@ Config::Config(int argc, char *argv[]) {
             to_gfa = true;
         } else if (!strcmp(argv[i], "--adj-rc")) {
             adjrc = true;
+        } else if (!strcmp(argv[i], "--node-first")) {
+            node_first = true;
         } else if (!strcmp(argv[i], "--compacted")) {
             output_compacted = true;
         } else if (!strcmp(argv[i], "--json")) {
@@ -430,8 +448,8 @@ Config::Config(int argc, char *argv[]) {
             arity_brwt = atoi(get_value(i++));
         } else if (!strcmp(argv[i], "--relax-arity")) {
             relax_arity_brwt = atoi(get_value(i++));
-        // } else if (!strcmp(argv[i], "--cache-size")) {
-        //     row_cache_size = atoi(get_value(i++));
+        } else if (!strcmp(argv[i], "--cache-size")) {
+            row_cache_size = atoi(get_value(i++));
         } else if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
             print_welcome_message();
             print_usage(argv[0], identity);
@@ -500,6 +518,12 @@ Config::Config(int argc, char *argv[]) {
     if (!count_kmers)
         count_width = 0;
 
+    if (fingerprint_bits < 1 || fingerprint_bits > 64) {
+        std::cerr << "Error: bad value for fingerprint-bits, must be between 1 and 64"
+                  << std::endl;
+        print_usage_and_exit = true;
+    }
+
     if (count_width > 32) {
         std::cerr << "Error: bad value for count-width, can use maximum 32 bits"
                      " to represent k-mer abundance" << std::endl;
@@ -625,6 +649,7 @@ Config::Config(int argc, char *argv[]) {
                                                  ".orhashdbg",
                                                  ".hashstrdbg",
                                                  ".hashfastdbg",
+                                                 ".hashmphfdbg",
                                                  ".bitmapdbg");
     if (identity == EXTEND && infbase.empty())
         print_usage_and_exit = true;
@@ -735,6 +760,8 @@ std::string Config::state_to_string(BOSS::State state) {
             return "small";
         case BOSS::State::FAST:
             return "fast";
+        case BOSS::State::INTERLEAVED:
+            return "interleaved";
     }
     throw std::runtime_error("Never happens");
 }
@@ -748,6 +775,8 @@ BOSS::State Config::string_to_state(const std::string &string) {
         return BOSS::State::SMALL;
     } else if (string == "fast") {
         return BOSS::State::FAST;
+    } else if (string == "interleaved") {
+        return BOSS::State::INTERLEAVED;
     } else {
         throw std::runtime_error("Error: unknown graph state");
     }
@@ -854,6 +883,9 @@ Config::GraphType Config::string_to_graphtype(const std::string &string) {
     } else if (string == "hashfast") {
         return GraphType::HASH_FAST;
 
+    } else if (string == "hashmphf") {
+        return GraphType::HASH_MPHF;
+
     } else if (string == "bitmap") {
         return GraphType::BITMAP;
 
@@ -963,8 +995,9 @@ if (advanced) {
             fprintf(stderr, "\t   --max-count-q [INT] \tmax k-mer abundance quantile (max-count is used by default) [1.0]\n");
             fprintf(stderr, "\t   --reference [STR] \tbasename of reference sequence (for parsing VCF files) []\n");
             fprintf(stderr, "\n");
-            fprintf(stderr, "\t   --graph [STR] \tgraph representation: succinct / bitmap / hash / hashstr / hashfast [succinct]\n");
-            fprintf(stderr, "\t   --state [STR] \tstate of succinct graph: small / dynamic / stat / fast [stat]\n");
+            fprintf(stderr, "\t   --graph [STR] \tgraph representation: succinct / bitmap / hash / hashstr / hashfast / hashmphf [succinct]\n");
+            fprintf(stderr, "\t   --state [STR] \tstate of succinct graph: small / dynamic / stat / fast / interleaved [stat]\n");
+            fprintf(stderr, "\t   --fingerprint-bits [INT] \tbits per k-mer fingerprint in hashmphf graph [16]\n");
             fprintf(stderr, "\t   --inplace \t\tconstruct succinct graph in-place and serialize without loading to RAM [off]\n");
             fprintf(stderr, "\t   --count-kmers \tcount k-mers and build weighted graph [off]\n");
             fprintf(stderr, "\t   --count-width \tnumber of bits used to represent k-mer abundance [8]\n");
@@ -1032,7 +1065,8 @@ if (advanced) {
             fprintf(stderr, "\n");
             fprintf(stderr, "\t-a --annotator [STR] \tannotator to extend []\n");
             fprintf(stderr, "\t-o --outfile-base [STR]\tbasename of output file []\n");
-            // fprintf(stderr, "\t-p --parallel [INT] \tuse multiple threads for computation [1]\n");
+            fprintf(stderr, "\t   --insert-batch-size [INT]\tmax number of base pairs merged into a succinct graph at once (0: all at once) [0]\n");
+            fprintf(stderr, "\t-p --parallel [INT] \tuse multiple threads for computation [1]\n");
         } break;
         case ALIGN: {
             fprintf(stderr, "Usage: %s align -i <GRAPH> [options] FASTQ1 [[FASTQ2] ...]\n\n", prog_name.c_str());
@@ -1094,6 +1128,13 @@ if (advanced) {
             fprintf(stderr, "\t   --align-min-exact-match [FLOAT] \t\tfraction of matching nucleotides required to align sequence [0.0]\n");
             fprintf(stderr, "\t   --align-max-num-seeds-per-locus [INT]\tthe maximum number of allowed inexact seeds per locus [inf]\n");
 }
+            fprintf(stderr, "\t   --sliding-sketch \t\t\t\tsketch all k-mers of a query in one pass (with --seeder sketch) [off]\n");
+            fprintf(stderr, "\t   --index-path [STR] \t\t\tbasename of the sketch index (with --seeder sketch) [graph path]\n");
+            fprintf(stderr, "\t   --load-index [INT] \t\t\tload the sketch index if present, or rebuild it if 0 [1]\n");
+            fprintf(stderr, "\t   --sketch-index-type [STR] \t\tfaiss index type for the sketch index, e.g. HNSW32, HNSW32_SQ8,\n"
+                            "\t                             \t\tIVF4096,PQ16 (IVF lists are mapped from disk) [HNSW32]\n");
+            fprintf(stderr, "\t   --sketch-ef-search [INT] \t\tsize of the candidate list in HNSW search [1000]\n");
+            fprintf(stderr, "\t   --sketch-nprobe [INT] \t\tnumber of inverted lists visited in IVF search [16]\n");
         } break;
         case COMPARE: {
             fprintf(stderr, "Usage: %s compare [options] GRAPH1 GRAPH2\n\n", prog_name.c_str());
@@ -1107,6 +1148,7 @@ if (advanced) {
             fprintf(stderr, "Available options for merge:\n");
             fprintf(stderr, "\t-b --bins-per-thread [INT] \tnumber of bins each thread computes on average [1]\n");
             fprintf(stderr, "\t   --dynamic \t\t\tdynamic merge by adding traversed paths [off]\n");
+            fprintf(stderr, "\t   --mem-cap-gb [FLOAT] \tmax size in GB of input graphs loaded at once with -p > 1 (0: no limit) [0]\n");
             fprintf(stderr, "\t   --part-idx [INT] \t\tidx to use when doing external merge []\n");
             fprintf(stderr, "\t   --parts-total [INT] \t\ttotal number of parts in external merge[]\n");
             fprintf(stderr, "\t-p --parallel [INT] \t\tuse multiple threads for computation [1]\n");
@@ -1131,10 +1173,11 @@ if (advanced) {
             fprintf(stderr, "\t   --index-ranges [INT]\tindex all node ranges in BOSS for suffixes of given length [%zu]\n", kDefaultIndexSuffixLen);
             fprintf(stderr, "\t   --clear-dummy \terase all redundant dummy edges and build an edgemask for non-redundant [off]\n");
             fprintf(stderr, "\t   --prune-tips [INT] \tprune all dead ends of this length and shorter [0]\n");
-            fprintf(stderr, "\t   --state [STR] \tchange state of succinct graph: small / dynamic / stat / fast [stat]\n");
+            fprintf(stderr, "\t   --state [STR] \tchange state of succinct graph: small / dynamic / stat / fast / interleaved [stat]\n");
             fprintf(stderr, "\t   --to-adj-list \twrite adjacency list to file [off]\n");
             fprintf(stderr, "\t   --to-fasta \t\textract sequences from graph and dump to compressed FASTA file [off]\n");
             fprintf(stderr, "\t   --adj-rc \t\tconstruct an index of adjacent to reverse-complement nodes (only for primary succinct graphs) [off]\n");
+            fprintf(stderr, "\t   --node-first \tconstruct an index of the first characters of nodes for fast backward traversal (only for succinct graphs) [off]\n");
             fprintf(stderr, "\t   --enumerate \t\tenumerate sequences in FASTA [off]\n");
             fprintf(stderr, "\t   --initialize-bloom \tconstruct a Bloom filter for faster detection of non-existing k-mers [off]\n");
             fprintf(stderr, "\t   --unitigs \t\textract all unitigs from graph and dump to compressed FASTA file [off]\n");
@@ -1184,6 +1227,10 @@ if (advanced) {
             fprintf(stderr, "\t   --count-dummy \tshow number of dummy source and sink edges [off]\n");
             fprintf(stderr, "\t-a --annotator [STR] \tannotation []\n");
             fprintf(stderr, "\t   --print-col-names \tprint names of the columns in annotation to screen [off]\n");
+            fprintf(stderr, "\t   --sketch-stats-queries [INT] \tnumber of sampled k-mers for evaluating the sketch index [100]\n");
+            fprintf(stderr, "\t   --sketch-ef-search [INT] \tsize of the candidate list in HNSW search [1000]\n");
+            fprintf(stderr, "\t   --sketch-nprobe [INT] \tnumber of inverted lists visited in IVF search [16]\n");
+            fprintf(stderr, "\t   --num-neighbours [INT] \tnumber of neighbours for the recall of the sketch index [10]\n");
             fprintf(stderr, "\t-p --parallel [INT] \tuse multiple threads for computation [1]\n");
         } break;
         case ANNOTATE: {
@@ -1328,7 +1375,7 @@ if (advanced) {
             // fprintf(stderr, "\t-d --distance [INT] \tmax allowed alignment distance [0]\n");
             fprintf(stderr, "\n");
             fprintf(stderr, "\t-p --parallel [INT] \tuse multiple threads for computation [1]\n");
-            // fprintf(stderr, "\t   --cache-size [INT] \tnumber of uncompressed rows to store in the cache [0]\n");
+            fprintf(stderr, "\t   --cache-size [INT] \tsize of the cache of reconstructed row-diff annotation rows in MiB [0]\n");
             fprintf(stderr, "\t   --fast \t\tquery in batches [off]\n");
             fprintf(stderr, "\t   --batch-size \tquery batch size (number of base pairs) [100000000]\n");
             fprintf(stderr, "\n");
@@ -1370,7 +1417,7 @@ if (advanced) {
             // fprintf(stderr, "\t-o --outfile-base [STR] \tbasename of output file []\n");
             // fprintf(stderr, "\t-d --distance [INT] \tmax allowed alignment distance [0]\n");
             fprintf(stderr, "\t-p --parallel [INT] \tmaximum number of parallel connections [1]\n");
-            // fprintf(stderr, "\t   --cache-size [INT] \tnumber of uncompressed rows to store in the cache [0]\n");
+            fprintf(stderr, "\t   --cache-size [INT] \tsize of the cache of reconstructed row-diff annotation rows in MiB [0]\n");
         } break;
         case SEQGEN: {
             fprintf(stderr, "Usage: generates sequences\n");
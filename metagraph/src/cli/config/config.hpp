@@ -34,6 +34,11 @@ class Config {
     size_t m = 10;
     size_t stride = m / 2;
     size_t num_neighbours = 10;
+    bool sliding_sketch = false;
+    std::string sketch_index_type = "HNSW32";
+    size_t sketch_ef_search = 1000;
+    size_t sketch_nprobe = 16;
+    size_t sketch_stats_queries = 100;
 
     // Sketcher params, the above are for the sketch itself
     uint32_t n_times_sketch = 5;
@@ -58,6 +63,7 @@ class Config {
     bool enumerate_out_sequences = false;
     bool to_gfa = false;
     bool adjrc = false;
+    bool node_first = false;
     bool output_compacted = false;
     bool unitigs = false;
     bool kmers_in_single_form = false;
@@ -118,9 +124,11 @@ class Config {
     unsigned int min_tip_size = 1;
     unsigned int min_unitig_median_kmer_abundance = 1;
     int fallback_abundance_cutoff = 1;
+    int fingerprint_bits = 16;
     unsigned int port = 5555;
     unsigned int bloom_max_num_hash_functions = 10;
     unsigned int num_columns_cached = 10;
+    unsigned int row_cache_size = 0;  // in MiB
     unsigned int max_hull_forks = 4;
     unsigned int row_diff_stage = 0;
     unsigned int max_path_length = 100;
@@ -128,6 +136,7 @@ class Config {
     unsigned int num_kmers_in_seq = 0;  // assume all input reads have this length
 
     unsigned long long int query_batch_size_in_bytes = 100'000'000;
+    unsigned long long int insert_batch_size = 0;
     unsigned long long int num_rows_subsampled = 1'000'000;
     unsigned long long int num_singleton_kmers = 0;
     unsigned long long int max_hull_depth = -1;  // the default is a function of input
@@ -248,6 +257,7 @@ class Config {
         HASH_PACKED,
         HASH_STR,
         HASH_FAST,
+        HASH_MPHF,
         BITMAP,
     };
 
@@ -67,6 +67,13 @@ std::unique_ptr<AnnotatedDBG> initialize_annotated_dbg(std::shared_ptr<DeBruijnG
                 row_diff_column->load_anchor(config.infbase + kRowDiffAnchorExt);
                 row_diff_column->load_fork_succ(config.infbase + kRowDiffForkSuccExt);
             }
+
+            if (config.row_cache_size) {
+                row_diff->set_row_cache(std::make_shared<RowCache>(
+                        static_cast<size_t>(config.row_cache_size) << 20));
+                logger->trace("Reconstructed annotation rows will be cached in {} MiB",
+                              config.row_cache_size);
+            }
         }
     }
 
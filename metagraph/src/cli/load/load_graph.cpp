@@ -7,6 +7,7 @@
 #include "graph/representation/hash/dbg_hash_ordered.hpp"
 #include "graph/representation/hash/dbg_hash_string.hpp"
 #include "graph/representation/hash/dbg_hash_fast.hpp"
+#include "graph/representation/hash/dbg_hash_mphf.hpp"
 #include "graph/representation/bitmap/dbg_bitmap.hpp"
 #include "graph/representation/succinct/dbg_succinct.hpp"
 #include "cli/config/config.hpp"
@@ -33,6 +34,9 @@ Config::GraphType parse_graph_type(const std::string &filename) {
     } else if (utils::ends_with(filename, DBGHashFast::kExtension)) {
         return Config::GraphType::HASH_FAST;
 
+    } else if (utils::ends_with(filename, DBGHashMPHF::kExtension)) {
+        return Config::GraphType::HASH_MPHF;
+
     } else if (utils::ends_with(filename, graph::DBGBitmap::kExtension)) {
         return Config::GraphType::BITMAP;
 
@@ -59,6 +63,9 @@ std::shared_ptr<DeBruijnGraph> load_critical_dbg(const std::string &filename) {
         case Config::GraphType::HASH_FAST:
             return load_critical_graph_from_file<DBGHashFast>(filename);
 
+        case Config::GraphType::HASH_MPHF:
+            return load_critical_graph_from_file<DBGHashMPHF>(filename);
+
         case Config::GraphType::BITMAP:
             return load_critical_graph_from_file<graph::DBGBitmap>(filename);
 
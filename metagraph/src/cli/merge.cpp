@@ -1,8 +1,12 @@
 #include "merge.hpp"
 
+#include <filesystem>
+
 #include "common/logger.hpp"
 #include "common/unix_tools.hpp"
 #include "common/threads/threading.hpp"
+#include "common/utils/file_utils.hpp"
+#include "common/utils/string_utils.hpp"
 #include "graph/representation/succinct/boss.hpp"
 #include "graph/representation/succinct/boss_merge.hpp"
 #include "graph/representation/succinct/dbg_succinct.hpp"
@@ -17,6 +21,126 @@ namespace cli {
 using mtg::common::logger;
 using mtg::common::get_verbose;
 
+const uint64_t kBytesInGigabyte = 1'000'000'000;
+
+
+// Load the graphs and check that they are all in the same mode
+std::vector<std::shared_ptr<graph::DBGSuccinct>>
+load_graphs(const std::vector<std::string> &files, Config *config) {
+    std::vector<std::shared_ptr<graph::DBGSuccinct>> dbg_graphs;
+
+    for (const auto &file : files) {
+        logger->info("Opening file '{}'", file);
+
+        dbg_graphs.emplace_back(load_critical_graph_from_file<graph::DBGSuccinct>(file));
+
+        if (get_verbose())
+            print_boss_stats(dbg_graphs.back()->get_boss());
+
+        if (dbg_graphs.front()->get_mode() != dbg_graphs.back()->get_mode()) {
+            logger->error("Input graphs are in different modes and thus incompatible for merge");
+            exit(1);
+        }
+    }
+
+    config->graph_mode = dbg_graphs.front()->get_mode();
+
+    return dbg_graphs;
+}
+
+// Merge the blocks of the graphs in parallel and stream them to chunk files
+// '<outbase>.<block>', then build the merged graph from these files after
+// releasing the input graphs, so that the inputs and the merged graph are
+// never in memory together.
+graph::boss::BOSS* merge_through_chunks(const std::vector<std::string> &files,
+                                        Config *config,
+                                        const std::string &outbase) {
+    auto dbg_graphs = load_graphs(files, config);
+
+    std::vector<const graph::boss::BOSS*> graphs;
+    for (const auto &dbg_graph : dbg_graphs) {
+        graphs.push_back(&dbg_graph->get_boss());
+    }
+
+    Timer timer;
+    logger->info("Start merging blocks");
+
+    auto chunk_files = graph::boss::merge_blocks_to_chunk_files(
+        graphs,
+        0, 1,
+        get_num_threads(),
+        config->num_bins_per_thread,
+        outbase,
+        get_verbose()
+    );
+    logger->info("Blocks merged in {} sec", timer.elapsed());
+
+    graphs.clear();
+    dbg_graphs.clear();
+
+    return graph::boss::BOSS::Chunk::build_boss_from_chunks(chunk_files, get_verbose());
+}
+
+// Merge the graphs with multiple threads, loading input graphs of at most
+// --mem-cap-gb in total at once (no limit if zero). If the inputs do not fit
+// into this budget, they are merged in groups, and the graph merged from each
+// group is merged with the following inputs in the next round.
+graph::boss::BOSS* merge_with_mem_cap(Config *config) {
+    const uint64_t mem_cap = config->memory_available * kBytesInGigabyte;
+
+    auto file_size = [](const std::string &file) {
+        return std::filesystem::file_size(
+            utils::make_suffix(file, graph::DBGSuccinct::kExtension)
+        );
+    };
+
+    auto tmp_dir = utils::create_temp_dir(utils::get_swap_path(), "merge");
+
+    std::vector<std::string> files = config->fnames;
+    assert(files.size() >= 2);
+
+    graph::boss::BOSS *graph = NULL;
+
+    for (size_t round = 0; ; ++round) {
+        // take as many inputs as fit into the budget, but at least two
+        size_t num_files = 2;
+        if (!mem_cap) {
+            num_files = files.size();
+        } else {
+            uint64_t total_size = file_size(files[0]) + file_size(files[1]);
+            while (num_files < files.size()
+                    && total_size + file_size(files[num_files]) <= mem_cap) {
+                total_size += file_size(files[num_files++]);
+            }
+        }
+
+        std::vector<std::string> group(files.begin(), files.begin() + num_files);
+        files.erase(files.begin(), files.begin() + num_files);
+
+        graph = merge_through_chunks(group, config,
+                                     (tmp_dir/("block." + std::to_string(round))).string());
+
+        // the graph merged in the previous round is not needed anymore
+        if (round)
+            std::filesystem::remove(group.front());
+
+        if (files.empty())
+            break;
+
+        logger->info("Merged {} graphs, {} more graphs left to merge",
+                     group.size(), files.size());
+
+        const auto merged_file = (tmp_dir/("merged." + std::to_string(round))).string();
+        graph::DBGSuccinct(graph, config->graph_mode).serialize(merged_file);
+        files.insert(files.begin(), utils::make_suffix(merged_file,
+                                                       graph::DBGSuccinct::kExtension));
+    }
+
+    utils::remove_temp_dir(tmp_dir);
+
+    return graph;
+}
+
 
 int merge_graph(Config *config) {
     assert(config);
@@ -27,26 +151,22 @@ int merge_graph(Config *config) {
 
     Timer timer;
 
-    std::vector<std::shared_ptr<graph::DBGSuccinct>> dbg_graphs;
-    std::vector<const graph::boss::BOSS*> graphs;
-
-    for (const auto &file : files) {
-        logger->info("Opening file '{}'", file);
+    if (!config->dynamic && config->parts_total <= 1 && get_num_threads() > 1) {
+        // the input graphs are loaded in merge_with_mem_cap
+        graph = merge_with_mem_cap(config);
 
-        dbg_graphs.emplace_back(load_critical_graph_from_file<graph::DBGSuccinct>(file));
+        logger->info("Graphs merged in {} sec", timer.elapsed());
 
-        graphs.push_back(&dbg_graphs.back()->get_boss());
+        graph::DBGSuccinct(graph, config->graph_mode).serialize(config->outfbase);
 
-        if (get_verbose())
-            print_boss_stats(*graphs.back());
+        return 0;
+    }
 
-        if (file == files.front())
-            config->graph_mode = dbg_graphs.back()->get_mode();
+    auto dbg_graphs = load_graphs(files, config);
 
-        if (config->graph_mode != dbg_graphs.back()->get_mode()) {
-            logger->error("Input graphs are in different modes and thus incompatible for merge");
-            exit(1);
-        }
+    std::vector<const graph::boss::BOSS*> graphs;
+    for (const auto &dbg_graph : dbg_graphs) {
+        graphs.push_back(&dbg_graph->get_boss());
     }
 
     logger->info("Graphs are loaded in {} sec", timer.elapsed());
@@ -72,7 +192,7 @@ int merge_graph(Config *config) {
 
             dbg_graphs.at(i).reset();
         }
-    } else if (get_num_threads() > 1 || config->parts_total > 1) {
+    } else if (config->parts_total > 1) {
         logger->info("Start merging blocks");
         timer.reset();
 
@@ -90,14 +210,10 @@ int merge_graph(Config *config) {
         }
         logger->info("Blocks merged in {} sec", timer.elapsed());
 
-        if (config->parts_total > 1) {
-            chunk.serialize(config->outfbase
-                              + "." + std::to_string(config->part_idx)
-                              + "_" + std::to_string(config->parts_total));
-        } else {
-            graph = new graph::boss::BOSS(graphs[0]->get_k());
-            chunk.initialize_boss(graph);
-        }
+        chunk.serialize(config->outfbase
+                          + "." + std::to_string(config->part_idx)
+                          + "_" + std::to_string(config->parts_total));
+        return 0;
     } else {
         logger->info("Start merging graphs");
         timer.reset();
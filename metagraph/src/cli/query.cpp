@@ -1,5 +1,6 @@
 #include "query.hpp"
 
+#include <future>
 #include <mutex>
 
 #include <ips4o.hpp>
@@ -28,6 +29,8 @@ namespace cli {
 
 const size_t kRowBatchSize = 100'000;
 const bool kPrefilterWithBloom = true;
+// number of contigs mapped to the full graph together in construct_query_graph
+const size_t kContigMappingBatchSize = 64;
 const char ALIGNED_SEQ_HEADER_FORMAT[] = "{}:{}:{}:{}";
 
 using namespace mtg::annot::binmat;
@@ -37,6 +40,7 @@ using namespace mtg::graph;
 using mtg::common::logger;
 using mtg::graph::boss::BOSS;
 using mtg::graph::boss::BOSSConstructor;
+using mtg::kmer::KmerBloomFilter;
 
 typedef typename mtg::graph::DeBruijnGraph::node_index node_index;
 
@@ -583,6 +587,8 @@ annot::LabelEncoder<> reencode_labels(const annot::LabelEncoder<> &encoder,
  * @param[in]  full_to_small    The mapping between the rows in the full matrix
  *                              and its submatrix.
  * @param[in]  num_threads      The number of threads used.
+ * @param[in]  query_coords     Keep the k-mer coordinates if the full matrix
+ *                              is a MultiIntMatrix.
  *
  * @return     Annotation submatrix
  */
@@ -590,7 +596,8 @@ std::unique_ptr<AnnotatedDBG::Annotator>
 slice_annotation(const AnnotatedDBG::Annotator &full_annotation,
                  uint64_t num_rows,
                  std::vector<std::pair<uint64_t, uint64_t>>&& full_to_small,
-                 size_t num_threads) {
+                 size_t num_threads,
+                 bool query_coords) {
     if (auto *rb = dynamic_cast<const RainbowMatrix *>(&full_annotation.get_matrix())) {
         // shortcut construction for Rainbow<> annotation
         std::vector<uint64_t> row_indexes(full_to_small.size());
@@ -630,6 +637,49 @@ slice_annotation(const AnnotatedDBG::Annotator &full_annotation,
                               utils::LessFirst(), num_threads);
     }
 
+    const auto *multi_int = dynamic_cast<const MultiIntMatrix *>(&full_annotation.get_matrix());
+    if (query_coords && multi_int) {
+        // carry the k-mer coordinates over to the query annotation
+        std::vector<MultiIntMatrix::RowTuples> slice(full_to_small.size());
+
+        #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+        for (uint64_t batch_begin = 0;
+                            batch_begin < full_to_small.size();
+                                            batch_begin += kRowBatchSize) {
+            const uint64_t batch_end
+                = std::min(batch_begin + kRowBatchSize,
+                           static_cast<uint64_t>(full_to_small.size()));
+
+            std::vector<uint64_t> row_indexes;
+            row_indexes.reserve(batch_end - batch_begin);
+            for (uint64_t i = batch_begin; i < batch_end; ++i) {
+                assert(full_to_small[i].first < full_annotation.num_objects());
+
+                row_indexes.push_back(full_to_small[i].first);
+            }
+
+            auto rows = multi_int->get_row_tuples(row_indexes);
+
+            assert(rows.size() == batch_end - batch_begin);
+
+            std::move(rows.begin(), rows.end(), slice.begin() + batch_begin);
+        }
+
+        auto label_encoder = reencode_labels(full_annotation.get_label_encoder(), &slice);
+
+        Vector<MultiIntMatrix::RowTuples> rows(num_rows);
+
+        for (uint64_t i = 0; i < slice.size(); ++i) {
+            rows[full_to_small[i].second] = std::move(slice[i]);
+        }
+
+        // copy annotations from the full graph to the query graph
+        return std::make_unique<annot::TupleRowAnnotator>(
+            std::make_unique<TupleCSRMatrix>(std::move(rows), label_encoder.size()),
+            std::move(label_encoder)
+        );
+    }
+
     if (const auto *mat = dynamic_cast<const IntMatrix *>(&full_annotation.get_matrix())) {
         std::vector<uint64_t> row_indexes;
         row_indexes.reserve(full_to_small.size());
@@ -716,10 +766,11 @@ void add_nodes_with_suffix_matches(const DBGSuccinct &full_dbg,
                                    size_t sub_k,
                                    size_t max_num_nodes_per_suffix,
                                    std::vector<std::pair<std::string, std::vector<node_index>>> *contigs,
-                                   bool check_reverse_complement) {
+                                   bool check_reverse_complement,
+                                   size_t num_threads) {
     std::vector<std::pair<std::string, std::vector<node_index>>> contig_buffer;
 
-    #pragma omp parallel for num_threads(get_num_threads()) schedule(dynamic)
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
     for (size_t i = 0; i < contigs->size(); ++i) {
         const auto &[contig, path] = (*contigs)[i];
         std::vector<std::pair<std::string, node_index>> added_nodes;
@@ -762,13 +813,14 @@ void add_hull_contigs(const DeBruijnGraph &full_dbg,
                       const DeBruijnGraph &batch_graph,
                       size_t max_hull_forks,
                       size_t max_hull_depth,
-                      std::vector<std::pair<std::string, std::vector<node_index>>> *contigs) {
+                      std::vector<std::pair<std::string, std::vector<node_index>>> *contigs,
+                      size_t num_threads) {
     tsl::hopscotch_map<node_index, uint32_t> distance_traversed_until_node;
 
     std::mutex mu;
     std::vector<std::pair<std::string, std::vector<node_index>>> contig_buffer;
 
-    #pragma omp parallel for num_threads(get_num_threads()) schedule(dynamic)
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
     for (size_t i = 0; i < contigs->size(); ++i) {
         const auto &[contig, path] = (*contigs)[i];
         std::vector<std::pair<std::string, std::vector<node_index>>> added_paths;
@@ -887,6 +939,83 @@ void add_to_graph(Graph &graph, const Contigs &contigs, size_t k) {
     }
 }
 
+// Call the maximal fragments of |sequence| made of k-mers not rejected by
+// the Bloom filter (the whole sequence, if |bloom_filter| is NULL)
+template <class Callback>
+void call_bloom_fragments(std::string_view sequence,
+                          size_t k,
+                          const KmerBloomFilter<> *bloom_filter,
+                          const Callback &callback) {
+    if (sequence.size() < k)
+        return;
+
+    auto is_missing = get_missing_kmer_skipper(bloom_filter, sequence);
+    size_t begin = 0;
+    for (size_t i = 0; i + k <= sequence.size(); ++i) {
+        if (is_missing()) {
+            if (begin < i)
+                callback(sequence.substr(begin, i - begin + k - 1));
+
+            begin = i + 1;
+        }
+    }
+    if (begin + k <= sequence.size())
+        callback(sequence.substr(begin));
+}
+
+/**
+ * Build a non-canonical batch graph from the query sequences in parallel.
+ * The k-mers are extracted with a KmerCollector, sorted and deduplicated by
+ * multiple threads, and the graph is built from them in bulk, instead of
+ * inserting every k-mer into a hash table one by one.
+ */
+std::shared_ptr<DBGSuccinct> build_batch_graph(size_t k,
+                                               StringGenerator call_sequences,
+                                               const KmerBloomFilter<> *bloom_filter,
+                                               size_t num_threads,
+                                               size_t *max_input_sequence_length) {
+    assert(k > 1);
+    assert(max_input_sequence_length);
+
+    BOSSConstructor constructor(k - 1, false, 0, "", num_threads);
+
+    if (!bloom_filter) {
+        call_sequences([&](const std::string &sequence) {
+            constructor.add_sequence(sequence);
+            if (*max_input_sequence_length < sequence.length())
+                *max_input_sequence_length = sequence.length();
+        });
+    } else {
+        std::vector<std::string> sequences;
+        call_sequences([&](const std::string &sequence) {
+            sequences.push_back(sequence);
+            if (*max_input_sequence_length < sequence.length())
+                *max_input_sequence_length = sequence.length();
+        });
+
+        // query the Bloom filter in parallel and pass on only the fragments
+        // that may be present in the full graph
+        #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+        for (size_t i = 0; i < sequences.size(); ++i) {
+            std::vector<std::string> fragments;
+            call_bloom_fragments(sequences[i], k, bloom_filter,
+                                 [&](std::string_view fragment) {
+                                     fragments.emplace_back(fragment);
+                                 });
+            sequences[i] = std::string();
+
+            #pragma omp critical
+            constructor.add_sequences(std::move(fragments));
+        }
+    }
+
+    auto graph = std::make_shared<DBGSuccinct>(new BOSS(&constructor));
+    // dummy k-mers must not be traversed when computing the hull
+    graph->mask_dummy_kmers(num_threads, false);
+
+    return graph;
+}
+
 /**
  * Construct a de Bruijn graph from the query sequences
  * fetched in |call_sequences|.
@@ -895,6 +1024,8 @@ void add_to_graph(Graph &graph, const Contigs &contigs, size_t k) {
  *
  * 1. Index k-mers from the query sequences in a non-canonical query de Bruijn
  *    graph (with pre-filtering by a Bloom filter, if initialized).
+ *    With multiple threads, the k-mers are collected and deduplicated in
+ *    parallel and the query graph is built from them in bulk.
  *    This query graph will be rebuilt as a canonical one in step 2.b), if the
  *    full graph is canonical.
  *
@@ -912,7 +1043,8 @@ std::unique_ptr<AnnotatedDBG>
 construct_query_graph(const AnnotatedDBG &anno_graph,
                       StringGenerator call_sequences,
                       size_t num_threads,
-                      const Config *config) {
+                      const Config *config,
+                      bool query_coords) {
     const auto &full_dbg = anno_graph.get_graph();
     const auto &full_annotation = anno_graph.get_annotator();
     const auto *dbg_succ = dynamic_cast<const DBGSuccinct *>(&full_dbg);
@@ -949,32 +1081,33 @@ construct_query_graph(const AnnotatedDBG &anno_graph,
     Timer timer;
 
     // construct graph storing all k-mers in query
-    auto graph_init = std::make_shared<DBGHashOrdered>(full_dbg.get_k());
+    std::shared_ptr<DeBruijnGraph> graph_init;
     size_t max_input_sequence_length = 0;
 
+    const KmerBloomFilter<> *bloom_filter
+        = kPrefilterWithBloom && dbg_succ && sub_k == full_dbg.get_k()
+            ? dbg_succ->get_bloom_filter()
+            : nullptr;
+
     logger->trace("[Query graph construction] Building the batch graph...");
 
-    if (kPrefilterWithBloom && dbg_succ && sub_k == full_dbg.get_k()) {
-        if (dbg_succ->get_bloom_filter())
-            logger->trace(
-                    "[Query graph construction] Started indexing k-mers pre-filtered "
-                    "with Bloom filter");
+    if (bloom_filter)
+        logger->trace("[Query graph construction] Started indexing k-mers pre-filtered "
+                      "with Bloom filter");
 
-        call_sequences([&](const std::string &sequence) {
-            // TODO: implement add_sequence with filter for all graph representations
-            graph_init->add_sequence(
-                sequence,
-                get_missing_kmer_skipper(dbg_succ->get_bloom_filter(), sequence)
-            );
-            if (max_input_sequence_length < sequence.length())
-                max_input_sequence_length = sequence.length();
-        });
+    if (num_threads > 1 && full_dbg.get_k() > 1) {
+        graph_init = build_batch_graph(full_dbg.get_k(), call_sequences, bloom_filter,
+                                       num_threads, &max_input_sequence_length);
     } else {
+        auto batch_graph = std::make_shared<DBGHashOrdered>(full_dbg.get_k());
         call_sequences([&](const std::string &sequence) {
-            graph_init->add_sequence(sequence);
+            // TODO: implement add_sequence with filter for all graph representations
+            batch_graph->add_sequence(sequence,
+                                      get_missing_kmer_skipper(bloom_filter, sequence));
             if (max_input_sequence_length < sequence.length())
                 max_input_sequence_length = sequence.length();
         });
+        graph_init = batch_graph;
     }
 
     max_hull_depth = std::min(
@@ -982,9 +1115,10 @@ construct_query_graph(const AnnotatedDBG &anno_graph,
         static_cast<size_t>(max_hull_depth_per_seq_char * max_input_sequence_length)
     );
 
+    const double extraction_time = timer.elapsed();
     logger->trace("[Query graph construction] Batch graph contains {} k-mers"
                   " and took {} sec to construct",
-                  graph_init->num_nodes(), timer.elapsed());
+                  graph_init->num_nodes(), extraction_time);
     timer.reset();
 
     // pull contigs from query graph
@@ -994,26 +1128,36 @@ construct_query_graph(const AnnotatedDBG &anno_graph,
                                    std::lock_guard<std::mutex> lock(seq_mutex);
                                    contigs.emplace_back(contig, std::vector<node_index>{});
                                },
-                               get_num_threads(),
+                               num_threads,
                                // pull only primary contigs when building canonical query graph
                                full_dbg.get_mode() == DeBruijnGraph::CANONICAL);
 
-    logger->trace("[Query graph construction] Contig extraction took {} sec", timer.elapsed());
+    const double contig_time = timer.elapsed();
+    logger->trace("[Query graph construction] Contig extraction took {} sec", contig_time);
     timer.reset();
 
     logger->trace("[Query graph construction] Mapping k-mers back to full graph...");
     // map from nodes in query graph to full graph
-    #pragma omp parallel for num_threads(get_num_threads())
-    for (size_t i = 0; i < contigs.size(); ++i) {
-        contigs[i].second.reserve(contigs[i].first.length() - graph_init->get_k() + 1);
-        full_dbg.map_to_nodes(contigs[i].first,
-                              [&](node_index node) { contigs[i].second.push_back(node); });
+    // the contigs are mapped in batches, interleaving the lookups of their k-mers
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+    for (size_t begin = 0; begin < contigs.size(); begin += kContigMappingBatchSize) {
+        const size_t end = std::min(begin + kContigMappingBatchSize, contigs.size());
+        std::vector<std::string_view> batch;
+        batch.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            batch.push_back(contigs[i].first);
+        }
+        auto nodes = full_dbg.map_to_nodes_batch(batch);
+        for (size_t i = begin; i < end; ++i) {
+            contigs[i].second = std::move(nodes[i - begin]);
+        }
     }
     logger->trace("[Query graph construction] Contigs mapped to the full graph in {} sec",
                   timer.elapsed());
     timer.reset();
 
     size_t original_size = contigs.size();
+    double hull_time = 0;
 
     // add nodes with suffix matches to the query
     if (sub_k < full_dbg.get_k()) {
@@ -1023,7 +1167,8 @@ construct_query_graph(const AnnotatedDBG &anno_graph,
         timer.reset();
 
         add_nodes_with_suffix_matches(*dbg_succ, sub_k, max_num_nodes_per_suffix,
-                                      &contigs, full_dbg.get_mode() == DeBruijnGraph::CANONICAL);
+                                      &contigs, full_dbg.get_mode() == DeBruijnGraph::CANONICAL,
+                                      num_threads);
 
         logger->trace("[Query graph construction] Found {} suffix-matching k-mers, took {} sec",
                       contigs.size() - original_size, timer.elapsed());
@@ -1036,18 +1181,32 @@ construct_query_graph(const AnnotatedDBG &anno_graph,
         timer.reset();
 
         // add k-mers with sub_k-suffix matches
-        for (size_t i = original_size; i < contigs.size(); ++i) {
-            graph_init->add_sequence(contigs[i].first);
+        if (auto *batch_succ = dynamic_cast<DBGSuccinct *>(graph_init.get())) {
+            std::vector<std::string> suffix_contigs;
+            for (size_t i = original_size; i < contigs.size(); ++i) {
+                suffix_contigs.push_back(contigs[i].first);
+            }
+            batch_succ->add_sequences(std::move(suffix_contigs),
+                                      [](node_index) {}, num_threads);
+        } else {
+            for (size_t i = original_size; i < contigs.size(); ++i) {
+                graph_init->add_sequence(contigs[i].first);
+            }
         }
 
         size_t hull_contigs_begin = contigs.size();
 
-        add_hull_contigs(full_dbg, *graph_init, max_hull_forks, max_hull_depth, &contigs);
+        add_hull_contigs(full_dbg, *graph_init, max_hull_forks, max_hull_depth, &contigs,
+                         num_threads);
 
+        hull_time = timer.elapsed();
         logger->trace("[Query graph augmentation] Augmented the batch graph with {} contigs in {} sec",
-                      contigs.size() - hull_contigs_begin, timer.elapsed());
+                      contigs.size() - hull_contigs_begin, hull_time);
     }
 
+    logger->trace("[Query graph construction] k-mer extraction: {} sec, contig calling: {} sec,"
+                  " hull extension: {} sec", extraction_time, contig_time, hull_time);
+
     graph_init.reset();
 
     logger->trace("[Query graph construction] Building the query graph...");
@@ -1120,7 +1279,8 @@ construct_query_graph(const AnnotatedDBG &anno_graph,
     auto annotation = slice_annotation(full_annotation,
                                        graph->max_index(),
                                        std::move(from_full_to_small),
-                                       num_threads);
+                                       num_threads,
+                                       query_coords);
 
     logger->trace("[Query graph construction] Query annotation with {} labels"
                   " and {} set bits constructed in {} sec",
@@ -1184,6 +1344,17 @@ int query_graph(Config *config) {
                       curr_timer.elapsed(), timer.elapsed());
     }
 
+    const auto &matrix = anno_graph->get_annotator().get_matrix();
+    if (const auto *row_diff = dynamic_cast<const annot::binmat::IRowDiff *>(&matrix)) {
+        if (const auto &row_cache = row_diff->row_cache()) {
+            auto stats = row_cache->get_stats();
+            logger->trace("Row cache: {} hits, {} misses (hit rate {:.3f}), {} hits on"
+                          " row-diff paths, {} rows cached in {:.1f} MiB",
+                          stats.hits, stats.misses, stats.hit_rate(), stats.path_hits,
+                          stats.num_rows, stats.num_bytes / 1048576.);
+        }
+    }
+
     return 0;
 }
 
@@ -1277,11 +1448,6 @@ void QueryExecutor::query_fasta(const string &file,
     }
 
     if (config_.fast) {
-        // TODO: Implement batch mode for query_coords queries
-        if (config_.query_coords) {
-            logger->error("Querying coordinates in batch mode is currently not supported");
-            exit(1);
-        }
         // Construct a query graph and query against it
         batched_query_fasta(fasta_parser, callback);
         return;
@@ -1312,70 +1478,115 @@ QueryExecutor::batched_query_fasta(seq_io::FastaParser &fasta_parser,
 
     size_t seq_count = 0;
 
-    while (it != end) {
+    struct QueryBatch {
+        std::vector<QuerySequence> seq_batch;
+        std::vector<Alignment> alignments_batch;
+        uint64_t num_bytes_read = 0;
+        std::unique_ptr<AnnotatedDBG> query_graph;
+    };
+
+    auto read_batch = [&]() {
+        QueryBatch batch;
+        for ( ; it != end && batch.num_bytes_read <= batch_size; ++it) {
+            batch.seq_batch.push_back(QuerySequence { seq_count++, it->name.s, it->seq.s });
+            batch.num_bytes_read += it->seq.l;
+        }
+        return batch;
+    };
+
+    auto query_batch = [&](QueryBatch batch, size_t num_threads) {
         Timer batch_timer;
 
-        uint64_t num_bytes_read = 0;
+        #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+        for (size_t i = 0; i < batch.seq_batch.size(); ++i) {
+            SeqSearchResult search_result
+                = query_sequence(std::move(batch.seq_batch[i]), *batch.query_graph, config_,
+                                 config_.batch_align ? aligner_config_.get() : NULL);
 
-        // A generator that can be called multiple times until all sequences
-        // are called
-        std::vector<QuerySequence> seq_batch;
-        std::vector<Alignment> alignments_batch;
-        num_bytes_read = 0;
+            if (batch.alignments_batch.size())
+                search_result.get_alignment() = std::move(batch.alignments_batch[i]);
 
-        for ( ; it != end && num_bytes_read <= batch_size; ++it) {
-            seq_batch.push_back(QuerySequence { seq_count++, it->name.s, it->seq.s });
-            num_bytes_read += it->seq.l;
+            callback(search_result);
         }
 
+        logger->trace("Batch of {} bytes from '{}' queried in {} sec", batch.num_bytes_read,
+                      fasta_parser.get_filename(), batch_timer.elapsed());
+    };
+
+    // The batches are processed in a pipeline: while the query graph is
+    // constructed for batch N, batch N+1 is parsed and batch N-1 is queried
+    // against its query graph. Thus, at most three batches are kept in memory.
+    // While both stages run, the threads are split between them, so that no
+    // more than get_num_threads() threads are busy at a time.
+    const size_t num_threads = std::max(1u, get_num_threads());
+    const size_t num_query_threads = num_threads / 2;
+
+    auto next_batch = std::async(std::launch::async, read_batch);
+    std::future<void> querying;
+
+    QueryBatch batch = next_batch.get();
+    while (batch.seq_batch.size()) {
+        // start parsing the next batch
+        next_batch = std::async(std::launch::async, read_batch);
+
+        const size_t num_construct_threads = querying.valid()
+                                                ? num_threads - num_query_threads
+                                                : num_threads;
+
+        Timer batch_timer;
+
         // Align sequences ahead of time on full graph if we don't have batch_align
         if (aligner_config_ && !config_.batch_align) {
-            alignments_batch.resize(seq_batch.size());
+            batch.alignments_batch.resize(batch.seq_batch.size());
             logger->trace("Aligning sequences from batch against the full graph...");
             batch_timer.reset();
 
-            #pragma omp parallel for num_threads(get_num_threads()) schedule(dynamic)
-            for (size_t i = 0; i < seq_batch.size(); ++i) {
+            #pragma omp parallel for num_threads(num_construct_threads) schedule(dynamic)
+            for (size_t i = 0; i < batch.seq_batch.size(); ++i) {
                 // Set alignment for this seq_batch
-                alignments_batch[i] = align_sequence(&seq_batch[i].sequence,
-                                                     anno_graph_, *aligner_config_);
+                batch.alignments_batch[i] = align_sequence(&batch.seq_batch[i].sequence,
+                                                           anno_graph_, *aligner_config_);
             }
             logger->trace("Sequences alignment took {} sec", batch_timer.elapsed());
             batch_timer.reset();
         }
 
         // Construct the query graph for this batch
-        auto query_graph = construct_query_graph(
+        batch.query_graph = construct_query_graph(
             anno_graph_,
             [&](auto callback) {
-                for (const auto &seq : seq_batch) {
+                for (const auto &seq : batch.seq_batch) {
                     callback(seq.sequence);
                 }
             },
-            get_num_threads(),
-            aligner_config_ && config_.batch_align ? &config_ : NULL
+            num_construct_threads,
+            aligner_config_ && config_.batch_align ? &config_ : NULL,
+            config_.query_coords
         );
 
         logger->trace("Query graph constructed for batch of sequences"
                       " with {} bases from '{}' in {} sec",
-                      num_bytes_read, fasta_parser.get_filename(), batch_timer.elapsed());
-        batch_timer.reset();
+                      batch.num_bytes_read, fasta_parser.get_filename(), batch_timer.elapsed());
 
-        #pragma omp parallel for num_threads(get_num_threads()) schedule(dynamic)
-        for (size_t i = 0; i < seq_batch.size(); ++i) {
-            SeqSearchResult search_result
-                = query_sequence(std::move(seq_batch[i]), *query_graph, config_,
-                                 config_.batch_align ? aligner_config_.get() : NULL);
+        // wait until the previous batch is queried
+        if (querying.valid())
+            querying.get();
 
-            if (alignments_batch.size())
-                search_result.get_alignment() = std::move(alignments_batch[i]);
+        QueryBatch following_batch = next_batch.get();
 
-            callback(search_result);
+        if (following_batch.seq_batch.empty() || !num_query_threads) {
+            // no other stage runs in the meantime, so query with all threads
+            query_batch(std::move(batch), num_threads);
+        } else {
+            querying = std::async(std::launch::async, query_batch,
+                                  std::move(batch), num_query_threads);
         }
 
-        logger->trace("Batch of {} bytes from '{}' queried in {} sec", num_bytes_read,
-                      fasta_parser.get_filename(), batch_timer.elapsed());
+        batch = std::move(following_batch);
     }
+
+    if (querying.valid())
+        querying.get();
 }
 
 } // namespace cli
@@ -58,12 +58,14 @@ collapse_coord_ranges(const std::vector<SmallVector<uint64_t>> &tuples);
  * @param call_sequences generate sequences to be queried against anno_graph
  * @param num_threads number of threads to use
  * @param config a pointer to a Config to determine parameters of the hull
+ * @param query_coords keep the k-mer coordinates stored in the annotation
  */
 std::unique_ptr<graph::AnnotatedDBG>
 construct_query_graph(const graph::AnnotatedDBG &anno_graph,
                       StringGenerator call_sequences,
                       size_t num_threads,
-                      const Config *config = nullptr);
+                      const Config *config = nullptr,
+                      bool query_coords = false);
 
 
 // Simple struct to wrap a query sequence
@@ -2,10 +2,14 @@
 #define __SEQGEN_GRAPH_HPP__
 
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace mtg {
 
 namespace graph {
+class DeBruijnGraph;
+
 namespace seqgen {
 struct DBGAlignerConfig;
 } // namespace align
@@ -16,6 +20,22 @@ class Config;
 
 int generate_sequences(Config *config);
 
+// Introduce substitutions, deletions and insertions into |s|, each at a
+// position with probability |mutation_rate| percent
+std::string mutate(std::string s, int mutation_rate, std::vector<char> alphabet);
+
+// Sample |num_paths| random walks with |min_path_size| to |max_path_size| nodes
+// from |graph| and return their spellings, the mutated spellings and the nodes
+void generate_sequences(const graph::DeBruijnGraph &graph,
+                        size_t min_path_size,
+                        size_t max_path_size,
+                        size_t num_paths,
+                        int mutation_rate,
+                        std::vector<char> alphabet,
+                        std::vector<std::string> &reference_spellings,
+                        std::vector<std::string> &mutated_spellings,
+                        std::vector<std::vector<uint64_t>> &paths);
+
 } // namespace cli
 } // namespace mtg
 
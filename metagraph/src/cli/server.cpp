@@ -9,6 +9,7 @@
 #include "graph/alignment/dbg_aligner.hpp"
 #include "graph/annotated_dbg.hpp"
 #include "annotation/int_matrix/base/int_matrix.hpp"
+#include "annotation/binary_matrix/row_diff/row_diff.hpp"
 #include "seq_io/sequence_io.hpp"
 #include "config/config.hpp"
 #include "load/load_graph.hpp"
@@ -77,17 +78,9 @@ std::string process_search_request(const std::string &received_message,
         throw std::invalid_argument("Annotation does not support k-mer count queries");
     }
 
-    if (config.query_coords) {
-        if (!dynamic_cast<const annot::matrix::MultiIntMatrix *>(
-                        &anno_graph.get_annotator().get_matrix())) {
-            throw std::invalid_argument("Annotation does not support k-mer coordinate queries");
-        }
-
-        if (config.fast) {
-            config.fast = false;
-            logger->warn("Attempted to query k-mer coordinates in batch mode. "
-                         "Defaulted to basic query mode.");
-        }
+    if (config.query_coords && !dynamic_cast<const annot::matrix::MultiIntMatrix *>(
+                                        &anno_graph.get_annotator().get_matrix())) {
+        throw std::invalid_argument("Annotation does not support k-mer coordinate queries");
     }
 
     std::unique_ptr<align::DBGAlignerConfig> aligner_config;
@@ -237,6 +230,22 @@ std::string process_stats_request(const graph::AnnotatedDBG &anno_graph,
     annotation_stats["objects"] = static_cast<uint64_t>(annotation.num_objects());
     annotation_stats["relations"] = static_cast<uint64_t>(annotation.num_relations());
 
+    using annot::binmat::IRowDiff;
+    if (const auto *row_diff = dynamic_cast<const IRowDiff *>(&annotation.get_matrix())) {
+        if (const auto &row_cache = row_diff->row_cache()) {
+            auto stats = row_cache->get_stats();
+            Json::Value cache_stats;
+            cache_stats["hits"] = stats.hits;
+            cache_stats["misses"] = stats.misses;
+            cache_stats["path_hits"] = stats.path_hits;
+            cache_stats["hit_rate"] = stats.hit_rate();
+            cache_stats["rows"] = stats.num_rows;
+            cache_stats["bytes"] = stats.num_bytes;
+            cache_stats["max_bytes"] = static_cast<uint64_t>(row_cache->max_bytes());
+            annotation_stats["row_cache"] = cache_stats;
+        }
+    }
+
     root["annotation"] = annotation_stats;
 
     Json::StreamWriterBuilder builder;
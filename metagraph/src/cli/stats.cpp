@@ -10,6 +10,7 @@
 #include "graph/representation/succinct/dbg_succinct.hpp"
 #include "graph/representation/succinct/boss.hpp"
 #include "graph/graph_extensions/node_weights.hpp"
+#include "graph/graph_extensions/sketch_index.hpp"
 #include "annotation/representation/row_compressed/annotate_row_compressed.hpp"
 #include "annotation/representation/column_compressed/annotate_column_compressed.hpp"
 #include "annotation/representation/annotation_matrix/static_annotators_def.hpp"
@@ -147,6 +148,33 @@ void print_stats(const graph::DeBruijnGraph &graph, bool print_counts_hist) {
     std::cout << "========================================================" << std::endl;
 }
 
+void print_sketch_index_stats(const graph::DeBruijnGraph &graph,
+                              graph::SketchIndex &sketch_index,
+                              size_t memory_bytes,
+                              const Config &config) {
+    const auto &params = sketch_index.get_params();
+    std::cout << "================== SKETCH INDEX STATS ==================" << std::endl;
+    std::cout << "index type: " << sketch_index.get_index_type() << std::endl;
+    std::cout << "embed dim: " << params.embed_dim << std::endl;
+    std::cout << "tuple length: " << params.tuple_length << std::endl;
+    std::cout << "repeats: " << params.n_times_sketch << std::endl;
+    std::cout << "sketch dim: " << sketch_index.get_sketcher().dim() << std::endl;
+    std::cout << "sketches: " << sketch_index.num_sketches() << std::endl;
+    // the mapped parts of the index count only once they are accessed
+    std::cout << "resident memory (MiB): " << memory_bytes / 1024. / 1024. << std::endl;
+
+    if (config.sketch_stats_queries && sketch_index.is_compatible(graph)) {
+        sketch_index.set_search_params(config.sketch_ef_search, config.sketch_nprobe);
+        auto stats = sketch_index.evaluate_search(graph, config.sketch_stats_queries,
+                                                  config.num_neighbours);
+        std::cout << "sampled queries: " << stats.num_queries << std::endl;
+        std::cout << "recall@" << stats.num_neighbours << ": " << stats.recall << std::endl;
+        std::cout << "query latency (us): " << stats.latency_us << std::endl;
+        std::cout << "exhaustive query latency (us): " << stats.exact_latency_us << std::endl;
+    }
+    std::cout << "========================================================" << std::endl;
+}
+
 template <class KmerHasher>
 void print_bloom_filter_stats(const kmer::KmerBloomFilter<KmerHasher> *kmer_bloom) {
     if (!kmer_bloom)
@@ -330,6 +358,12 @@ int print_stats(Config *config) {
 
         print_stats(*graph, config->print_counts_hist);
 
+        size_t rss_before = get_curr_RSS();
+        if (auto sketch_index = graph->load_extension<graph::SketchIndex>(file)) {
+            ts::init_alphabet("dna4");
+            print_sketch_index_stats(*graph, *sketch_index, get_curr_RSS() - rss_before, *config);
+        }
+
         if (auto dbg_succ = dynamic_cast<graph::DBGSuccinct*>(graph.get())) {
             const auto &boss_graph = dbg_succ->get_boss();
 
@@ -6,6 +6,7 @@
 #include "common/unix_tools.hpp"
 #include "common/threads/threading.hpp"
 #include "graph/representation/succinct/dbg_succinct.hpp"
+#include "graph/graph_extensions/node_first_cache.hpp"
 #include "graph/graph_extensions/node_rc.hpp"
 #include "config/config.hpp"
 #include "load/load_graph.hpp"
@@ -40,8 +41,18 @@ int transform_graph(Config *config) {
     if (!dbg_succ.get())
         throw std::runtime_error("Only implemented for DBGSuccinct");
 
-    if (config->adjrc) {
-        graph::NodeRC(*dbg_succ, true).serialize(config->outfbase + dbg_succ->file_extension());
+    if (config->adjrc || config->node_first) {
+        if (config->adjrc)
+            graph::NodeRC(*dbg_succ, true).serialize(config->outfbase + dbg_succ->file_extension());
+
+        if (config->node_first) {
+            logger->trace("Indexing the first characters of nodes...");
+            timer.reset();
+            graph::NodeFirstCache node_first(*dbg_succ);
+            node_first.index_first_chars(get_num_threads());
+            node_first.serialize(config->outfbase + dbg_succ->file_extension());
+            logger->trace("Indexing done in {} sec", timer.elapsed());
+        }
         return 0;
     }
 
@@ -102,13 +113,10 @@ int transform_graph(Config *config) {
             exit(1);
         }
 
-        logger->trace("Index all node ranges for suffixes of length {} in {:.2f} MB",
-                      suffix_length,
-                      std::pow(dbg_succ->get_boss().alph_size - 1, suffix_length)
-                            * 2. * sizeof(uint64_t) * 1e-6);
+        logger->trace("Index node ranges for suffixes of length {}", suffix_length);
         timer.reset();
 
-        dbg_succ->get_boss().index_suffix_ranges(suffix_length);
+        dbg_succ->get_boss().index_suffix_ranges(suffix_length, get_num_threads());
 
         logger->trace("Indexing of node ranges took {} sec", timer.elapsed());
         timer.reset();
@@ -0,0 +1,124 @@
+#include "mphf.hpp"
+
+#include <cassert>
+#include <algorithm>
+
+#include "common/serialization.hpp"
+#include "common/vectors/vector_algorithm.hpp"
+
+
+namespace mtg {
+namespace common {
+
+// map |hash| uniformly to [0, size)
+static inline uint64_t fast_range(uint64_t hash, uint64_t size) {
+    return (static_cast<__uint128_t>(hash) * size) >> 64;
+}
+
+uint64_t MinimalPerfectHash::hash(uint64_t key, uint64_t seed) {
+    // the finalizer of splitmix64
+    uint64_t x = key + (seed + 1) * 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+MinimalPerfectHash::MinimalPerfectHash(std::vector<uint64_t>&& keys,
+                                       double gamma,
+                                       size_t num_threads) : size_(keys.size()) {
+    assert(gamma >= 1);
+    num_threads = std::max(num_threads, size_t(1));
+
+    std::vector<sdsl::bit_vector> levels;
+
+    for (size_t level = 0; level < kMaxNumLevels && keys.size(); ++level) {
+        // the levels are aligned to words for concatenation
+        const uint64_t level_size = (static_cast<uint64_t>(gamma * keys.size()) + 64) / 64 * 64;
+        sdsl::bit_vector hit(level_size, false);
+        sdsl::bit_vector collided(level_size, false);
+
+        #pragma omp parallel for num_threads(num_threads) schedule(static, 1024)
+        for (uint64_t i = 0; i < keys.size(); ++i) {
+            uint64_t pos = fast_range(hash(keys[i], level), level_size);
+            if (fetch_and_set_bit(hit.data(), pos, true, __ATOMIC_RELAXED))
+                set_bit(collided.data(), pos, true, __ATOMIC_RELAXED);
+        }
+
+        // keep the positions hit by exactly one key
+        uint64_t *hit_data = hit.data();
+        const uint64_t *collided_data = collided.data();
+        for (uint64_t i = 0; i < level_size / 64; ++i) {
+            hit_data[i] &= ~collided_data[i];
+        }
+
+        // the colliding keys are passed on to the next level
+        keys.erase(std::remove_if(keys.begin(), keys.end(), [&](uint64_t key) {
+            return !collided[fast_range(hash(key, level), level_size)];
+        }), keys.end());
+
+        level_offsets_.push_back(level_offsets_.back() + level_size);
+        levels.push_back(std::move(hit));
+    }
+
+    sdsl::bit_vector bits(level_offsets_.back(), false);
+    for (size_t level = 0; level < levels.size(); ++level) {
+        std::copy(levels[level].data(),
+                  levels[level].data() + levels[level].size() / 64,
+                  bits.data() + level_offsets_[level] / 64);
+    }
+    levels.clear();
+    levels_ = bit_vector_stat(std::move(bits));
+
+    std::sort(keys.begin(), keys.end());
+    assert(std::adjacent_find(keys.begin(), keys.end()) == keys.end()
+            && "the keys must be distinct");
+    fallback_keys_ = std::move(keys);
+
+    assert(levels_.num_set_bits() + fallback_keys_.size() == size_);
+}
+
+uint64_t MinimalPerfectHash::operator()(uint64_t key) const {
+    for (size_t level = 0; level + 1 < level_offsets_.size(); ++level) {
+        uint64_t level_size = level_offsets_[level + 1] - level_offsets_[level];
+        uint64_t pos = level_offsets_[level] + fast_range(hash(key, level), level_size);
+        if (uint64_t rank = levels_.conditional_rank1(pos))
+            return rank - 1;
+    }
+
+    auto it = std::lower_bound(fallback_keys_.begin(), fallback_keys_.end(), key);
+    if (it != fallback_keys_.end() && *it == key)
+        return levels_.num_set_bits() + (it - fallback_keys_.begin());
+
+    return size_;
+}
+
+void MinimalPerfectHash::serialize(std::ostream &out) const {
+    serialize_number(out, size_);
+    serialize_number_vector_raw(out, level_offsets_);
+    levels_.serialize(out);
+    serialize_number_vector_raw(out, fallback_keys_);
+}
+
+bool MinimalPerfectHash::load(std::istream &in) {
+    if (!in.good())
+        return false;
+
+    try {
+        size_ = load_number(in);
+        level_offsets_ = load_number_vector_raw<uint64_t>(in);
+        if (level_offsets_.empty() || !levels_.load(in))
+            return false;
+
+        fallback_keys_ = load_number_vector_raw<uint64_t>(in);
+
+        return in.good()
+                && levels_.size() == level_offsets_.back()
+                && levels_.num_set_bits() + fallback_keys_.size() == size_;
+
+    } catch (...) {
+        return false;
+    }
+}
+
+} // namespace common
+} // namespace mtg
@@ -0,0 +1,57 @@
+#ifndef __MPHF_HPP__
+#define __MPHF_HPP__
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "common/vectors/bit_vector_sdsl.hpp"
+
+
+namespace mtg {
+namespace common {
+
+/**
+ * A minimal perfect hash function over a static set of 64-bit keys,
+ * constructed as in BBHash (Limasset et al., 2017).
+ *
+ * The keys are hashed into a bit array of size |gamma| * n. The positions hit by
+ * exactly one key are set and the colliding keys are passed on to the next level,
+ * with a new hash function. The index of a key is the rank of its position in the
+ * concatenated levels. The few keys left after the last level are stored explicitly.
+ * With gamma = 2, the function takes about 3.7 bits per key.
+ */
+class MinimalPerfectHash {
+  public:
+    MinimalPerfectHash() {}
+    // |keys| must be distinct
+    explicit MinimalPerfectHash(std::vector<uint64_t>&& keys,
+                                double gamma = 2,
+                                size_t num_threads = 1);
+
+    // Returns the index in [0, size()) assigned to |key|. For keys not from the
+    // set, returns either an arbitrary index in [0, size()) or size().
+    uint64_t operator()(uint64_t key) const;
+
+    uint64_t size() const { return size_; }
+
+    bool load(std::istream &in);
+    void serialize(std::ostream &out) const;
+
+    static uint64_t hash(uint64_t key, uint64_t seed);
+
+  private:
+    static constexpr size_t kMaxNumLevels = 32;
+
+    uint64_t size_ = 0;
+    // level i occupies the bits [level_offsets_[i], level_offsets_[i + 1])
+    std::vector<uint64_t> level_offsets_ = { 0 };
+    bit_vector_stat levels_;
+    // the keys not placed in any of the levels, sorted
+    std::vector<uint64_t> fallback_keys_;
+};
+
+} // namespace common
+} // namespace mtg
+
+#endif // __MPHF_HPP__
@@ -275,6 +275,45 @@ inline __m256d fmafast_pd(__m256d a, __m256d b, __m256d c) {
     return _mm256_add_pd(_mm256_mul_pd(a, b), c);
 }
 
+/**
+ * Helpers for tensor sketching
+ */
+
+// a[i] = z * b[i] + (1 - z) * a[i] for all i in [0, len)
+inline void convex_sum_inplace_avx2(double *a, const double *b, size_t len, double z) {
+    const __m256d zv = _mm256_set1_pd(z);
+    const __m256d wv = _mm256_set1_pd(1 - z);
+    size_t i = 0;
+    for ( ; i + 4 <= len; i += 4) {
+        __m256d av = _mm256_mul_pd(wv, _mm256_loadu_pd(a + i));
+#ifdef __FMA__
+        _mm256_storeu_pd(a + i, _mm256_fmadd_pd(zv, _mm256_loadu_pd(b + i), av));
+#else
+        _mm256_storeu_pd(a + i, fmafast_pd(zv, _mm256_loadu_pd(b + i), av));
+#endif
+    }
+    for ( ; i < len; ++i) {
+        a[i] = z * b[i] + (1 - z) * a[i];
+    }
+}
+
+inline void convex_sum_inplace_avx2(float *a, const float *b, size_t len, float z) {
+    const __m256 zv = _mm256_set1_ps(z);
+    const __m256 wv = _mm256_set1_ps(1 - z);
+    size_t i = 0;
+    for ( ; i + 8 <= len; i += 8) {
+        __m256 av = _mm256_mul_ps(wv, _mm256_loadu_ps(a + i));
+#ifdef __FMA__
+        _mm256_storeu_ps(a + i, _mm256_fmadd_ps(zv, _mm256_loadu_ps(b + i), av));
+#else
+        _mm256_storeu_ps(a + i, _mm256_add_ps(_mm256_mul_ps(zv, _mm256_loadu_ps(b + i)), av));
+#endif
+    }
+    for ( ; i < len; ++i) {
+        a[i] = z * b[i] + (1 - z) * a[i];
+    }
+}
+
 #endif // __AVX2__
 
 #endif // __SIMD_UTILS_HPP__
@@ -2,12 +2,14 @@
 
 #include <type_traits>
 #include <cassert>
+#include <algorithm>
 
 #include "bit_vector_adaptive.hpp"
 #include "bit_vector_sdsl.hpp"
 #include "bit_vector_dyn.hpp"
 #include "bit_vector_sd.hpp"
 #include "vector_algorithm.hpp"
+#include "common/threads/threading.hpp"
 
 
 std::ostream& operator<<(std::ostream &os, const bit_vector &bv) {
@@ -187,14 +189,11 @@ bit_vector::to_vector_adaptive(double WORD_ACCESS_VS_SELECT_FACTOR) const {
         // moderate density
         result.resize(size());
 
-        uint64_t i;
         const uint64_t end = size();
         uint64_t *data = result.data();
-        for (i = 0; i + 64 <= end; i += 64, ++data) {
-            *data = get_int(i, 64);
-        }
-        if (i < size()) {
-            *data = get_int(i, size() - i);
+        #pragma omp parallel for num_threads(get_num_threads()) schedule(static, 1024)
+        for (uint64_t i = 0; i < end; i += 64) {
+            data[i >> 6] = get_int(i, std::min(end - i, uint64_t(64)));
         }
     }
 
@@ -214,14 +213,11 @@ void bit_vector::add_to_adaptive(sdsl::bit_vector *other,
                            WORD_ACCESS_VS_SELECT_FACTOR);
     } else {
         // moderate density
-        uint64_t i;
         const uint64_t end = size();
         uint64_t *data = other->data();
-        for (i = 0; i + 64 <= end; i += 64, ++data) {
-            *data |= get_int(i, 64);
-        }
-        if (i < size()) {
-            *data |= get_int(i, size() - i);
+        #pragma omp parallel for num_threads(get_num_threads()) schedule(static, 1024)
+        for (uint64_t i = 0; i < end; i += 64) {
+            data[i >> 6] |= get_int(i, std::min(end - i, uint64_t(64)));
         }
     }
 }
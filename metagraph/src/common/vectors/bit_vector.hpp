@@ -38,6 +38,9 @@ class bit_vector : public bitmap {
     virtual uint64_t next1(uint64_t id) const = 0;
     virtual uint64_t prev1(uint64_t id) const = 0;
 
+    // Hint that the bit |id| and its rank will be queried soon
+    virtual void prefetch(uint64_t /* id */) const {}
+
     virtual bool operator[](uint64_t id) const override = 0;
     virtual uint64_t get_int(uint64_t id, uint32_t width) const override = 0;
 
@@ -57,6 +57,8 @@ class bit_vector_sdsl : public bit_vector {
     inline uint64_t next1(uint64_t id) const override;
     inline uint64_t prev1(uint64_t id) const override;
 
+    inline void prefetch(uint64_t id) const override;
+
     inline bool operator[](uint64_t id) const override;
     inline uint64_t get_int(uint64_t id, uint32_t width) const override;
 
@@ -221,6 +223,18 @@ bit_vector_sdsl<bv_type, rank_1_type, select_1_type, select_0_type>
     }
 }
 
+template <class bv_type, class rank_1_type, class select_1_type, class select_0_type>
+void
+bit_vector_sdsl<bv_type, rank_1_type, select_1_type, select_0_type>
+::prefetch(uint64_t id) const {
+    // only the word storing the bit is prefetched, the rank and select
+    // support structures of sdsl do not expose their layout
+    if constexpr(std::is_same_v<bv_type, sdsl::bit_vector>) {
+        if (id < size())
+            __builtin_prefetch(vector_.data() + (id >> 6));
+    }
+}
+
 template <class bv_type, class rank_1_type, class select_1_type, class select_0_type>
 bool
 bit_vector_sdsl<bv_type, rank_1_type, select_1_type, select_0_type>
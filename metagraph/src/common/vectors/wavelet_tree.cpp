@@ -1,6 +1,7 @@
 #include "wavelet_tree.hpp"
 
 #include <cassert>
+#include <algorithm>
 
 #include "common/serialization.hpp"
 #include "common/utils/template_utils.hpp"
@@ -445,22 +446,44 @@ partite_vector<t_bv>::partite_vector(uint8_t logsigma,
         int_vector_ = pack_vector(std::move(vector), logsigma);
     }
 
-    std::vector<sdsl::bit_vector> bitmaps(1 << logsigma);
-
-    for (size_t i = 0; i < int_vector_.size(); ++i) {
-
-        TAlphabet c = int_vector_[i];
-
-        assert(c < static_cast<uint64_t>(bitmaps.size()));
+    const size_t num_threads = get_num_threads();
+    const uint64_t size = int_vector_.size();
+
+    // mark the characters occurring in the vector
+    std::vector<std::vector<bool>> occurs(num_threads,
+                                          std::vector<bool>(1 << logsigma, false));
+    #pragma omp parallel for num_threads(num_threads) schedule(static)
+    for (size_t t = 0; t < num_threads; ++t) {
+        for (uint64_t i = size * t / num_threads; i < size * (t + 1) / num_threads; ++i) {
+            assert(int_vector_[i] < occurs[t].size());
+            occurs[t][int_vector_[i]] = true;
+        }
+    }
 
-        if (!bitmaps[c].size())
-            bitmaps[c] = sdsl::bit_vector(int_vector_.size(), 0);
+    std::vector<sdsl::bit_vector> bitmaps(1 << logsigma);
+    for (TAlphabet c = 0; c < bitmaps.size(); ++c) {
+        for (size_t t = 0; t < num_threads; ++t) {
+            if (occurs[t][c]) {
+                bitmaps[c] = sdsl::bit_vector(size, 0);
+                break;
+            }
+        }
+    }
 
-        bitmaps[c][i] = 1;
+    // fill the bitmaps in blocks of 64 positions, so that no two threads write
+    // to the same word
+    #pragma omp parallel for num_threads(num_threads) schedule(static, 1024)
+    for (uint64_t i = 0; i < size; i += 64) {
+        for (uint64_t j = i; j < std::min(i + 64, size); ++j) {
+            bitmaps[int_vector_[j]][j] = 1;
+        }
     }
 
-    for (auto &bv : bitmaps) {
-        bitmaps_.emplace_back(std::move(bv));
+    // construct the rank/select support for each bitmap independently
+    bitmaps_.resize(bitmaps.size());
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+    for (TAlphabet c = 0; c < bitmaps.size(); ++c) {
+        bitmaps_[c] = t_bv(std::move(bitmaps[c]));
     }
 }
 
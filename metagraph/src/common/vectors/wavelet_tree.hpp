@@ -34,6 +34,10 @@ class wavelet_tree {
     virtual uint8_t logsigma() const = 0;
     virtual uint64_t count(TAlphabet c) const = 0;
 
+    // Hint that rank(c, i) will be queried soon. Representations in which
+    // the memory accessed by the query is known in advance prefetch it.
+    virtual void prefetch(uint64_t /* i */, TAlphabet /* c */) const {}
+
     virtual bool load(std::istream &in) = 0;
     virtual void serialize(std::ostream &out) const = 0;
 
@@ -129,6 +133,11 @@ class partite_vector : public wavelet_tree_sdsl_augmented {
     uint8_t logsigma() const { return int_vector_.width(); }
     uint64_t count(TAlphabet c) const { return bitmaps_[c].num_set_bits(); }
 
+    void prefetch(uint64_t i, TAlphabet c) const {
+        assert(c < bitmaps_.size());
+        bitmaps_[c].prefetch(i);
+    }
+
     bool load(std::istream &in);
     void serialize(std::ostream &out) const;
 
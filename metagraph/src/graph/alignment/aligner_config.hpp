@@ -115,6 +115,12 @@ struct DBGAlignerConfig {
     uint32_t n_times_sketch = 10;
     uint32_t minimizer_window = 20;
     size_t num_neighbours = 10;
+    // sketch all windows of a query in one pass with a sliding sketch
+    bool sliding_sketch = false;
+    // size of the candidate list in the HNSW sketch index search
+    size_t sketch_ef_search = 1000;
+    // number of inverted lists visited in the IVF sketch index search
+    size_t sketch_nprobe = 16;
 };
 
 } // namespace align
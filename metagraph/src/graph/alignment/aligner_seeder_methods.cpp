@@ -1,5 +1,6 @@
 #include "aligner_seeder_methods.hpp"
 
+#include "graph/graph_extensions/sketch_index.hpp"
 #include "graph/representation/succinct/dbg_succinct.hpp"
 #include "graph/representation/canonical_dbg.hpp"
 #include "common/logger.hpp"
@@ -12,20 +13,10 @@ namespace align {
 
 using mtg::common::logger;
 using namespace boost::multiprecision;
-typedef std::pair<float, Seed> pi;
 
 typedef Alignment::score_t score_t;
 //using key_type = boost::multiprecision::uint256_t;
 using key_type = uint64_t;
-struct myComp {
-    constexpr bool operator()(
-            pi const& a,
-            pi const& b)
-    const noexcept
-    {
-        return a.first < b.first;
-    }
-};
 
 ExactSeeder::ExactSeeder(const DeBruijnGraph &graph,
                          std::string_view query,
@@ -94,101 +85,185 @@ auto ExactSeeder::get_seeds() const -> std::vector<Seed> {
     return seeds;
 }
 
-std::vector<Seed> SketchSeeder::get_seeds() const {
+size_t SketchSeeder::num_search_kmers() const {
     size_t k = graph_.get_k();
+    if (config_.max_seed_length < k || query_.size() < k)
+        return 0;
 
-    assert(k >= config_.min_seed_length);
+    return query_.size() - k + 1;
+}
 
-    size_t end_clipping = query_.size() - k;
+void SketchSeeder::search_batch(const std::vector<const SketchSeeder*> &seeders) {
+    if (seeders.empty())
+        return;
 
-    // Convert query string to integer alphabet
-    std::vector<uint8_t> query_to_int;
-    for (unsigned char c: query_) {
-        query_to_int.push_back(ts::char2int(c));
+    const DeBruijnGraph &graph = seeders[0]->graph_;
+    const DBGAlignerConfig &config = seeders[0]->config_;
+
+    const auto *sketch_index = graph.get_extension_threadsafe<SketchIndex>();
+    if (!sketch_index) {
+        logger->error("Sketch index must be built or loaded before seeding");
+        exit(1);
     }
-    uint32_t num_neighs = config_.num_neighbours;
-    std::vector<Seed> seeds;
-    seeds.reserve(num_neighs*(query_.size() - k));
-    if (config_.max_seed_length < k)
-        return seeds;
+    const ts::KmerSketcher &sketcher = sketch_index->get_sketcher();
+    assert(sketcher.get_k() == graph.get_k());
+    const size_t sketch_dim = sketcher.dim();
+    const size_t num_neighs = config.num_neighbours;
+
+    // offsets of the query k-mers of each seeder in the batch
+    std::vector<size_t> offsets;
+    offsets.reserve(seeders.size() + 1);
+    offsets.push_back(0);
+    size_t max_query_size = 0;
+    for (const SketchSeeder *seeder : seeders) {
+        assert(&seeder->graph_ == &graph);
+        size_t nq = seeder->num_search_kmers();
+        offsets.push_back(offsets.back() + nq);
+        if (nq)
+            max_query_size = std::max(max_query_size, seeder->query_.size());
+
+        seeder->neighbours_.resize(config.n_times_sketch * nq * num_neighs);
+        seeder->distances_.resize(config.n_times_sketch * nq * num_neighs);
+    }
+
+    const size_t total_nq = offsets.back();
+    if (!total_nq)
+        return;
+
+    // The buffers are kept between calls and only grow, so that the aligner
+    // threads do not allocate them anew for every batch.
+    static thread_local SearchBuffers buffers;
+    auto &[xq, I, D, scratch, window_sketches, queries_to_int] = buffers;
+
+    xq.resize(total_nq * sketch_dim);
+    I.resize(total_nq * num_neighs);
+    D.resize(total_nq * num_neighs);
+
+    scratch.resize(config.sliding_sketch ? sketcher.sliding_scratch_size()
+                                         : sketcher.scratch_size());
+    if (config.sliding_sketch)
+        window_sketches.resize((max_query_size - sketcher.window() + 1) * sketcher.embed_dim());
+
+    // queries converted to the integer alphabet
+    if (queries_to_int.size() < seeders.size())
+        queries_to_int.resize(seeders.size());
+
+    for (size_t s = 0; s < seeders.size(); ++s) {
+        if (offsets[s + 1] == offsets[s])
+            continue;
+
+        const auto &query = seeders[s]->query_;
+        queries_to_int[s].resize(query.size());
+        std::transform(query.begin(), query.end(), queries_to_int[s].begin(),
+                       [](unsigned char c) { return ts::char2int(c); });
+    }
+
+    for (uint32_t n_repeat = 0; n_repeat < config.n_times_sketch; ++n_repeat) {
+        for (size_t s = 0; s < seeders.size(); ++s) {
+            const size_t nq = offsets[s + 1] - offsets[s];
+            if (!nq)
+                continue;
 
-    uint32_t nq = query_.size() - k + 1;
-    uint32_t num_regions = (query_.size() - k + 1) / k;
-    double stride_ratio = 0.1;
-    double window_ratio = 0.2;
-    uint32_t stride = static_cast<uint32_t>(stride_ratio * (double)k);
-    uint32_t window = static_cast<uint32_t>(window_ratio * (double)k);
-    uint32_t num_windows = static_cast<uint32_t>(std::ceil((double)(k - window + 1) / (double)stride));
-
-
-    uint32_t embed_dim = config_.embed_dim;
-    for (uint32_t n_repeat = 0; n_repeat < config_.n_times_sketch; n_repeat++) {
-        std::priority_queue<pi, std::vector<pi>, myComp> pq;
-        idx_t* I = new idx_t[num_neighs  * nq];
-        float* D = new float[num_neighs * nq];
-        float* xq = new float[embed_dim * num_windows * nq];
-
-        uint32_t pos = 0;
-        for(uint32_t kmer_start = 0; kmer_start < query_.size() - k + 1; ++kmer_start) {
-            std::vector<uint8_t> kmer_string(query_to_int.begin() + kmer_start, query_to_int.begin() + kmer_start + k);
-//            std::cout << kmer_start << " " << query_.substr(kmer_start, k) << std::endl;
-            // Get full sketch
-            std::vector<double> full_sketch;
-            full_sketch.reserve(embed_dim * num_windows);
-
-            for(uint32_t mmer_start = 0; mmer_start < k - window + 1; mmer_start += stride) {
-                std::vector<uint8_t> mmer_string(kmer_string.begin() + mmer_start, kmer_string.begin() + mmer_start + window);
-                std::vector<double> sketch = ts::Tensor<uint8_t>(config_.kmer_word_size, config_.embed_dim, config_.tuple_length, n_repeat).compute(mmer_string);
-                full_sketch.insert(full_sketch.end(), sketch.begin(), sketch.end());
+            const auto &query_to_int = queries_to_int[s];
+            float *query_xq = xq.data() + offsets[s] * sketch_dim;
+            if (config.sliding_sketch) {
+                // every window of the query is sketched only once and shared by all k-mers
+                sketcher.compute_all_into(query_to_int.data(), query_to_int.size(), n_repeat,
+                                          query_xq, window_sketches.data(), scratch.data());
+            } else {
+                for (size_t kmer_start = 0; kmer_start < nq; ++kmer_start) {
+                    sketcher.compute_into(query_to_int.data() + kmer_start, n_repeat,
+                                          query_xq + kmer_start * sketch_dim, scratch.data());
+                }
             }
-            for(uint32_t j = 0; j < embed_dim * num_windows; ++j) {
-                xq[pos * embed_dim * num_windows + j] = full_sketch[j];
+        }
+
+        // a single search for the k-mers of all queries in the batch
+        sketch_index->search(total_nq, xq.data(), num_neighs, D.data(), I.data());
+
+        for (size_t s = 0; s < seeders.size(); ++s) {
+            const size_t begin = offsets[s] * num_neighs;
+            const size_t end = offsets[s + 1] * num_neighs;
+            const size_t dest = n_repeat * (end - begin);
+            std::copy(I.begin() + begin, I.begin() + end,
+                      seeders[s]->neighbours_.begin() + dest);
+            std::copy(D.begin() + begin, D.begin() + end,
+                      seeders[s]->distances_.begin() + dest);
+        }
+    }
+}
+
+std::vector<Seed> SketchSeeder::get_seeds() const {
+    size_t k = graph_.get_k();
+    assert(k >= config_.min_seed_length);
+
+    const size_t nq = num_search_kmers();
+    if (!nq)
+        return {};
+
+    const size_t num_neighs = config_.num_neighbours;
+    const uint32_t num_repeats = config_.n_times_sketch;
+    if (neighbours_.size() != num_repeats * nq * num_neighs)
+        search_batch({ this });
+
+    std::vector<Seed> seeds;
+    seeds.reserve(nq * num_neighs);
+
+    // (node, repeat, distance relative to the farthest neighbour in that repeat)
+    std::vector<std::tuple<node_index, uint32_t, float>> hits;
+    hits.reserve(num_repeats * num_neighs);
+    // (aggregated distance, node)
+    std::vector<std::pair<float, node_index>> candidates;
+    candidates.reserve(num_repeats * num_neighs);
+
+    for (size_t i = 0; i < nq; ++i) {
+        // The aggregated distance of a node is the sum of its distances to the
+        // query k-mer over all repeats. If the node is not among the neighbours
+        // found in a repeat, the distance of the farthest neighbour found in that
+        // repeat is used, which is a lower bound for the actual distance.
+        hits.clear();
+        float missing_distance = 0;
+        for (uint32_t n_repeat = 0; n_repeat < num_repeats; ++n_repeat) {
+            const size_t begin = (n_repeat * nq + i) * num_neighs;
+            const idx_t *I = neighbours_.data() + begin;
+            const float *D = distances_.data() + begin;
+
+            float max_distance = 0;
+            for (size_t j = 0; j < num_neighs; ++j) {
+                // faiss returns -1 if fewer neighbours were found
+                if (I[j] >= 0)
+                    max_distance = std::max(max_distance, D[j]);
+            }
+            missing_distance += max_distance;
+
+            for (size_t j = 0; j < num_neighs; ++j) {
+                if (I[j] >= 0)
+                    hits.emplace_back(I[j], n_repeat, D[j] - max_distance);
             }
-            pos++;
         }
-        graph_.index->search(nq, xq, num_neighs, D, I);
-
-
-        Seed best_seed;
-        float best_distance = std::numeric_limits<float>::max();
-        for(uint32_t i = 0; i < nq; ++i) {
-            for(uint32_t j = 0; j < num_neighs; ++j) {
-
-                node_index near_neighbour = (node_index)(I[i * num_neighs + j]);
-                double near_neighbour_distance = D[i * num_neighs + j];
-                //                std::cout << near_neighbour << " ";
-//                std::cout << near_neighbour << " " << graph_.debugmap[near_neighbour] << std::endl;
-//                std::cout << near_neighbour << " distance  " << near_neighbour_distance << std::endl;
-//                std::cout << query_.substr(i, k) << std::endl;
-//                std::cout << graph_.get_node_sequence(graph_.debugmap[near_neighbour]) << std::endl;
-//                std::cout << graph_.get_node_sequence(near_neighbour) << " " << (query_.substr(i, k) == graph_.get_node_sequence(near_neighbour)) << std::endl;
-//                if(D[i * num_neighs + j] < best_distance) {
-//                    best_distance = D[i * num_neighs + j];
-//                    best_seed = Seed(query_.substr(i, k),
-//                            std::vector<node_index>{ near_neighbour },
-//                            orientation_, 0, i, query_.size() - (k + i));
-//                }
-                seeds.emplace_back(query_.substr(i, k),
-                                   std::vector<node_index>{ near_neighbour },
-                                   orientation_, 0, i, query_.size() - (k + i));
-//                pq.push(std::make_pair(near_neighbour_distance,
-//                                       Seed(query_.substr(i, k), std::vector<node_index>{ near_neighbour }, orientation_, 0, i, query_.size() - (k + i))));
-//                if (pq.size() > num_neighs) {
-//                    pq.pop();
-//                }
+
+        // collapse the hits of the same node, keeping the closest one per repeat
+        std::sort(hits.begin(), hits.end());
+        candidates.clear();
+        for (auto it = hits.begin(); it != hits.end(); ++it) {
+            const auto &[node, n_repeat, distance] = *it;
+            if (candidates.empty() || candidates.back().second != node) {
+                candidates.emplace_back(missing_distance + distance, node);
+            } else if (n_repeat != std::get<1>(*(it - 1))) {
+                candidates.back().first += distance;
             }
-//            if ((i + 1) % 1 == 0 || i == nq - 1) {
-////                best_distance = std::numeric_limits<float>::max();
-////                seeds.emplace_back(best_seed);
-//                while(!pq.empty()) {
-//                    seeds.emplace_back(pq.top().second);
-//                    pq.pop();
-//                }
-//            }
-//            std::cout << std::endl;
         }
-    }
 
+        // keep only the best hits for this query k-mer
+        size_t num_best = std::min(num_neighs, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + num_best,
+                          candidates.end());
+        for (size_t j = 0; j < num_best; ++j) {
+            seeds.emplace_back(query_.substr(i, k),
+                               std::vector<node_index>{ candidates[j].second },
+                               orientation_, 0, i, query_.size() - (k + i));
+        }
+    }
 
     return seeds;
 }
@@ -143,6 +143,11 @@ class SketchSeeder : public ISeeder {
         std::vector<Alignment> get_alignments() const override;
         size_t get_num_matches() const override final { return 0; } // TODO: Implement this
 
+        // Sketch the k-mers of all queries of |seeders| and search them in the sketch
+        // index with a single call per repeat. The neighbours found are stored in the
+        // seeders and used by get_seeds. All seeders must share the same graph and config.
+        static void search_batch(const std::vector<const SketchSeeder*> &seeders);
+
     protected:
         std::unordered_map<int, std::string> sketches;
         const DeBruijnGraph &graph_;
@@ -150,6 +155,25 @@ class SketchSeeder : public ISeeder {
         bool orientation_;
         std::vector<node_index> query_nodes_;
         const DBGAlignerConfig &config_;
+
+        // Number of query k-mers searched in the sketch index
+        size_t num_search_kmers() const;
+
+        // Nearest neighbours of the query k-mers and their distances, stored in the
+        // order [repeat][k-mer][neighbour]. Computed by search_batch, or in get_seeds
+        // if the seeder was not part of a batch.
+        mutable std::vector<idx_t> neighbours_;
+        mutable std::vector<float> distances_;
+
+        // Buffers used by search_batch, reused between batches
+        struct SearchBuffers {
+            std::vector<float> sketches;
+            std::vector<idx_t> neighbours;
+            std::vector<float> distances;
+            std::vector<double> scratch;
+            std::vector<float> window_sketches;
+            std::vector<std::vector<uint8_t>> queries_to_int;
+        };
 };
 
 class UniMEMSeeder : public MEMSeeder {
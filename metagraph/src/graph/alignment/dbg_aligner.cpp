@@ -190,6 +190,20 @@ auto DBGAligner<Seeder, Extender, AlignmentCompare>
     result.reserve(seq_batch.size());
     ProgressBar progress_bar(seq_batch.size(), "Seeding sequences",
                              std::cerr, !common::get_verbose());
+    std::vector<const SketchSeeder*> sketch_seeders;
+
+    // map the k-mers of all queries in the batch at once, which lets the graph
+    // interleave the lookups of different queries
+    std::vector<std::vector<node_index>> batch_nodes;
+    if (config_.max_seed_length >= graph_.get_k()) {
+        std::vector<std::string_view> queries;
+        queries.reserve(seq_batch.size());
+        for (const auto &[header, query] : seq_batch) {
+            queries.push_back(query);
+        }
+        batch_nodes = graph_.map_to_nodes_sequentially_batch(queries);
+    }
+
     for (size_t i = 0; i < seq_batch.size(); ++i, ++progress_bar) {
         const auto &[header, query] = seq_batch[i];
         std::string_view this_query = wrapped_seqs[i].get_query(false);
@@ -197,7 +211,7 @@ auto DBGAligner<Seeder, Extender, AlignmentCompare>
 
         std::vector<node_index> nodes;
         if (config_.max_seed_length >= graph_.get_k()) {
-            nodes = map_to_nodes_sequentially(graph_, query);
+            nodes = std::move(batch_nodes[i]);
         } else if (this_query.size() >= graph_.get_k()) {
             nodes.resize(this_query.size() - graph_.get_k() + 1);
         }
@@ -225,8 +239,20 @@ auto DBGAligner<Seeder, Extender, AlignmentCompare>
                                                  std::move(nodes_rc), config_);
         }
 #endif
+        if constexpr(std::is_same_v<Seeder, SketchSeeder>) {
+            sketch_seeders.push_back(seeder.get());
+            if (seeder_rc)
+                sketch_seeders.push_back(seeder_rc.get());
+        }
+
         result.emplace_back(std::move(seeder), std::move(seeder_rc));
     }
+
+    // The k-mers of all queries in the batch are searched in the sketch index
+    // together, which is much faster than searching them query by query.
+    if constexpr(std::is_same_v<Seeder, SketchSeeder>)
+        SketchSeeder::search_batch(sketch_seeders);
+
     return result;
 }
 
@@ -1,19 +1,29 @@
 #include "node_first_cache.hpp"
 
+#include <fstream>
+
+#include "common/hashers/hash.hpp"
+#include "common/logger.hpp"
+#include "common/serialization.hpp"
+#include "common/utils/string_utils.hpp"
+#include "common/vectors/vector_algorithm.hpp"
+
 namespace mtg {
 namespace graph {
 
+using mtg::common::logger;
+
+// number of BOSS edges whose labels are hashed into the checksum
+static const uint64_t kNumChecksumEdges = 1 << 10;
+
+
 char NodeFirstCache::get_first_char(node_index node) const {
     assert(dbg_succ_);
     const boss::BOSS &boss = dbg_succ_->get_boss();
 
     edge_index edge = dbg_succ_->kmer_to_boss_index(node);
-    assert(boss.bwd(edge) == get_parent_pair(edge).first);
 
-    boss::BOSS::TAlphabet s = boss.get_node_last_value(get_parent_pair(edge).second);
-    assert(s == boss.get_minus_k_value(edge, boss.get_k() - 1).first);
-
-    return boss.decode(s);
+    return boss.decode(get_first_value(edge));
 }
 
 void NodeFirstCache::call_incoming_kmers(node_index node,
@@ -26,7 +36,9 @@ void NodeFirstCache::call_incoming_kmers(node_index node,
     edge_index edge = dbg_succ_->kmer_to_boss_index(node);
 
     edge_index bwd = 0;
-    if (auto fetch = first_cache_.TryGet(edge)) {
+    if (is_indexed()) {
+        bwd = boss.bwd(edge);
+    } else if (auto fetch = first_cache_.TryGet(edge)) {
         assert(fetch->first == boss.bwd(edge));
         bwd = fetch->first;
     } else {
@@ -39,18 +51,173 @@ void NodeFirstCache::call_incoming_kmers(node_index node,
                     == boss.get_node_last_value(edge));
 
             node_index prev = dbg_succ_->boss_to_kmer_index(incoming_boss_edge);
-            if (prev != DeBruijnGraph::npos) {
-                boss::BOSS::TAlphabet s = boss.get_node_last_value(
-                    get_parent_pair(incoming_boss_edge, edge).second
-                );
-                assert(boss.get_minus_k_value(incoming_boss_edge,
-                                              boss.get_k() - 1).first == s);
-                callback(prev, boss.decode(s));
-            }
+            if (prev != DeBruijnGraph::npos)
+                callback(prev, boss.decode(get_first_value(incoming_boss_edge, edge)));
         }
     );
 }
 
+auto NodeFirstCache::get_first_value(edge_index edge, edge_index child_hint) const
+        -> boss::BOSS::TAlphabet {
+    const boss::BOSS &boss = dbg_succ_->get_boss();
+
+    boss::BOSS::TAlphabet s = is_indexed()
+        ? first_chars_[edge]
+        : boss.get_node_last_value(get_parent_pair(edge, child_hint).second);
+
+    assert(s == boss.get_minus_k_value(edge, boss.get_k() - 1).first);
+    return s;
+}
+
+void NodeFirstCache::index_first_chars(size_t num_threads) {
+    assert(dbg_succ_);
+    const boss::BOSS &boss = dbg_succ_->get_boss();
+    const size_t k = boss.get_k();
+
+    using TAlphabet = boss::BOSS::TAlphabet;
+
+    k_ = dbg_succ_->get_k();
+    boss_checksum_ = boss_checksum(boss);
+    first_chars_ = sdsl::int_vector<>(boss.num_edges() + 1, 0,
+                                      sdsl::bits::hi(boss.alph_size - 1) + 1);
+    const uint8_t width = first_chars_.width();
+
+    // the nodes already processed, marked at their last edges
+    sdsl::bit_vector visited(first_chars_.size(), false);
+
+    // Assign the first character to all edges of the node with the last edge
+    // |node| and call its children in the spanning tree of the graph, that is,
+    // the targets of its edges with labels not marked with minus.
+    auto visit_node = [&](edge_index node, TAlphabet first, const auto &callback) {
+        if (fetch_and_set_bit(visited.data(), node, true))
+            return;
+
+        for (edge_index e = boss.pred_last(node - 1) + 1; e <= node; ++e) {
+            // several threads may write to the same word
+            for (uint8_t b = 0; b < width; ++b) {
+                if ((first >> b) & 1)
+                    set_bit(first_chars_.data(), e * width + b, true, __ATOMIC_RELAXED);
+            }
+            TAlphabet c = boss.get_W(e);
+            if (c && c < boss.alph_size)
+                callback(boss.fwd(e, c), c);
+        }
+    };
+
+    // Visit all nodes reachable from |node| with the label |label|.
+    // Only the label of the current node is kept, in a ring buffer of k characters
+    // starting at |front|. The other branches are put on the stack and their
+    // labels are reconstructed from the graph when they are taken.
+    auto traverse = [&](edge_index node, std::vector<TAlphabet> label) {
+        assert(label.size() == k);
+        size_t front = 0;
+        std::vector<edge_index> stack;
+        while (true) {
+            edge_index next = 0;
+            TAlphabet next_c = 0;
+            visit_node(node, label[front], [&](edge_index child, TAlphabet c) {
+                if (next) {
+                    stack.push_back(child);
+                } else {
+                    next = child;
+                    next_c = c;
+                }
+            });
+
+            if (next) {
+                // shift the label by one character
+                label[front] = next_c;
+                front = (front + 1) % k;
+                node = next;
+                continue;
+            }
+
+            do {
+                if (stack.empty())
+                    return;
+
+                node = stack.back();
+                stack.pop_back();
+            } while (fetch_bit(visited.data(), node, true));
+
+            label = boss.get_node_seq(node);
+            front = 0;
+        }
+    };
+
+    // Traverse the graph from the dummy source node $$...$ breadth-first until
+    // there are enough subtrees to be traversed in parallel
+    std::vector<std::pair<edge_index, std::vector<TAlphabet>>> tasks
+        = { { boss.succ_last(1), std::vector<TAlphabet>(k, boss::BOSS::kSentinelCode) } };
+    const size_t min_num_tasks = std::max(num_threads, size_t(1)) * 64;
+    while (tasks.size() && tasks.size() < min_num_tasks) {
+        std::vector<std::pair<edge_index, std::vector<TAlphabet>>> next_tasks;
+        for (const auto &[node, label] : tasks) {
+            visit_node(node, label.front(), [&](edge_index next, TAlphabet c) {
+                auto &next_label = next_tasks.emplace_back(next, label).second;
+                next_label.erase(next_label.begin());
+                next_label.push_back(c);
+            });
+        }
+        tasks.swap(next_tasks);
+    }
+
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        traverse(tasks[i].first, std::move(tasks[i].second));
+    }
+
+    // the nodes not reachable from the dummy source (e.g., on cycles
+    // when the dummy edges are pruned)
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1024)
+    for (edge_index node = 1; node < first_chars_.size(); ++node) {
+        if (boss.get_last(node) && !fetch_bit(visited.data(), node, true))
+            traverse(node, boss.get_node_seq(node));
+    }
+}
+
+bool NodeFirstCache::load(const std::string &filename_base) {
+    const auto filename = utils::make_suffix(filename_base, kFirstCharsExtension);
+    try {
+        std::ifstream instream(filename, std::ios::binary);
+        if (!instream.good())
+            return false;
+
+        k_ = load_number(instream);
+        boss_checksum_ = load_number(instream);
+        first_chars_.load(instream);
+        return instream.good();
+
+    } catch (...) {
+        return false;
+    }
+}
+
+void NodeFirstCache::serialize(const std::string &filename_base) const {
+    if (!is_indexed())
+        logger->warn("NodeFirstCache was not indexed, so nothing to serialize.");
+
+    const auto filename = utils::make_suffix(filename_base, kFirstCharsExtension);
+
+    std::ofstream outstream(filename, std::ios::binary);
+    serialize_number(outstream, k_);
+    serialize_number(outstream, boss_checksum_);
+    first_chars_.serialize(outstream);
+}
+
+uint64_t NodeFirstCache::boss_checksum(const boss::BOSS &boss) {
+    std::vector<uint64_t> fingerprint { boss.get_k(), boss.num_edges() };
+
+    // hash the labels of edges sampled evenly from the table
+    const uint64_t step = std::max(boss.num_edges() / kNumChecksumEdges, uint64_t(1));
+    for (edge_index e = 1; e <= boss.num_edges(); e += step) {
+        fingerprint.push_back(boss.get_W(e));
+        fingerprint.push_back(boss.get_last(e));
+    }
+
+    return utils::VectorHash()(fingerprint);
+}
+
 bool NodeFirstCache::is_compatible(const SequenceGraph &graph, bool verbose) const {
     const auto *dbg_succ = dynamic_cast<const DBGSuccinct*>(&graph);
     if (!dbg_succ) {
@@ -67,6 +234,21 @@ bool NodeFirstCache::is_compatible(const SequenceGraph &graph, bool verbose) con
         return false;
     }
 
+    if (is_indexed() && first_chars_.size() != dbg_succ->get_boss().num_edges() + 1) {
+        if (verbose)
+            std::cerr << "Index does not match the number of edges in graph\n";
+
+        return false;
+    }
+
+    if (is_indexed() && (k_ != dbg_succ->get_k()
+                            || boss_checksum_ != boss_checksum(dbg_succ->get_boss()))) {
+        if (verbose)
+            std::cerr << "Index was not computed from this graph\n";
+
+        return false;
+    }
+
     return true;
 }
 
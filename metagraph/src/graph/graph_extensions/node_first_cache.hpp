@@ -3,6 +3,7 @@
 
 #include <cache.hpp>
 #include <lru_cache_policy.hpp>
+#include <sdsl/int_vector.hpp>
 
 #include "graph/representation/succinct/dbg_succinct.hpp"
 
@@ -13,6 +14,11 @@ namespace graph {
 // This cache stores intermediate results from BOSS bwd calls to speed up calls
 // to call_incoming_kmers in DBGSuccinct.
 // This stores 80 bytes per cached 8-byte node index.
+//
+// Alternatively, the first characters of all nodes can be precomputed with
+// index_first_chars() or loaded with load(). The index takes log(|alphabet|) bits
+// per BOSS edge, makes get_first_char a single lookup, and can be shared by
+// multiple threads.
 class NodeFirstCache : public SequenceGraph::GraphExtension {
   public:
     using node_index = typename SequenceGraph::node_index;
@@ -27,8 +33,15 @@ class NodeFirstCache : public SequenceGraph::GraphExtension {
 
     void call_incoming_kmers(node_index node, const IncomingEdgeCallback &callback) const;
 
-    bool load(const std::string &) { throw std::runtime_error("Not implemented"); }
-    void serialize(const std::string &) const { throw std::runtime_error("Not implemented"); }
+    // Precompute the first characters of all nodes with a single traversal
+    // of the BOSS graph. The LRU cache is not used after that.
+    void index_first_chars(size_t num_threads = 1);
+    bool is_indexed() const { return first_chars_.size(); }
+
+    // Load or serialize the precomputed first characters, together with k and
+    // a checksum of the BOSS table they were computed from
+    bool load(const std::string &filename_base);
+    void serialize(const std::string &filename_base) const;
 
     bool is_compatible(const SequenceGraph &graph, bool verbose = true) const;
 
@@ -37,6 +50,15 @@ class NodeFirstCache : public SequenceGraph::GraphExtension {
 
     using edge_index = boss::BOSS::edge_index;
 
+    // The first character of the source node of each BOSS edge, if indexed
+    sdsl::int_vector<> first_chars_;
+    // k and the checksum of the BOSS table first_chars_ were computed from
+    uint64_t k_ = 0;
+    uint64_t boss_checksum_ = 0;
+
+    // Fingerprint of the BOSS table: its size and the labels of sampled edges
+    static uint64_t boss_checksum(const boss::BOSS &boss);
+
     // Maps a BOSS edge e to the pair (bwd(e), bwd^(k-1)(e)), where k is the node
     // size in a BOSS graph.
     // Thus, first_cache_[e] == boss.get_minus_k_value(e, boss.get_k() - 1).first
@@ -48,6 +70,11 @@ class NodeFirstCache : public SequenceGraph::GraphExtension {
     // pair is cached and compute the pair for edge using that result.
     std::pair<edge_index, edge_index>
     get_parent_pair(edge_index edge, edge_index child_hint = 0) const;
+
+    // The first character (encoded) of the source node of the BOSS edge
+    boss::BOSS::TAlphabet get_first_value(edge_index edge, edge_index child_hint = 0) const;
+
+    static constexpr auto kFirstCharsExtension = ".node_first";
 };
 
 } // namespace graph
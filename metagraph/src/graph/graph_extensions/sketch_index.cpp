@@ -0,0 +1,510 @@
+#include "sketch_index.hpp"
+
+#include <fstream>
+#include <mutex>
+#include <random>
+
+#include <faiss/IndexHNSW.h>
+#include <faiss/IndexIVF.h>
+#include <faiss/MetaIndexes.h>
+#include <faiss/impl/AuxIndexStructures.h>
+#include <faiss/index_factory.h>
+#include <faiss/index_io.h>
+
+#include "common/hashers/hash.hpp"
+#include "common/logger.hpp"
+#include "common/serialization.hpp"
+#include "common/unix_tools.hpp"
+#include "sequence/alphabets.hpp"
+
+
+namespace mtg {
+namespace graph {
+
+using mtg::common::logger;
+
+// number of k-mers sketched in parallel before adding them to the index
+static const uint64_t kSketchBatchSize = 1 << 14;
+// number of nodes whose sequences are hashed into the graph checksum
+static const uint64_t kNumChecksumNodes = 1 << 10;
+static const uint64_t kHeaderVersion = 2;
+static const size_t kDefaultEfSearch = 1000;
+static const size_t kDefaultNprobe = 16;
+
+
+// Returns the index wrapped by the id map, if any
+static faiss::Index* get_base_index(faiss::Index *index) {
+    if (auto *id_map = dynamic_cast<faiss::IndexIDMap2*>(index))
+        return id_map->index;
+
+    return index;
+}
+
+// Check if entries can be removed from the index (e.g., HNSW does not support it)
+static bool supports_removal(faiss::Index *index) {
+    try {
+        index->remove_ids(faiss::IDSelectorBatch(0, nullptr));
+        return true;
+    } catch (const std::exception &) {
+        return false;
+    }
+}
+
+
+SketchIndex::SketchIndex(const DeBruijnGraph &graph,
+                         const Params &params,
+                         const std::string &index_type,
+                         size_t num_threads)
+      : params_(params), index_type_(index_type), graph_checksum_(graph_checksum(graph)) {
+    const uint32_t k = graph.get_k();
+    if (params_.k != k) {
+        logger->error("Sketching parameters do not match the graph: k={} but the graph has k={}",
+                      params_.k, k);
+        exit(1);
+    }
+
+    sketcher_ = std::make_shared<ts::KmerSketcher>(params_.kmer_word_size, params_.embed_dim,
+                                                   params_.tuple_length, k,
+                                                   params_.n_times_sketch);
+    init_index();
+    set_search_params(kDefaultEfSearch, kDefaultNprobe);
+
+    index_unitigs(graph, num_threads, [](const auto &) { return true; });
+}
+
+void SketchIndex::init_index() {
+    assert(sketcher_);
+    faiss::Index *base_index;
+    try {
+        base_index = faiss::index_factory(sketcher_->dim(), index_type_.c_str(),
+                                          faiss::METRIC_L2);
+    } catch (const std::exception &e) {
+        logger->error("Cannot construct sketch index of type '{}': {}", index_type_, e.what());
+        exit(1);
+    }
+    auto *id_map = new faiss::IndexIDMap2(base_index);
+    id_map->own_fields = true;
+    index_.reset(id_map);
+}
+
+void SketchIndex::index_unitigs(const DeBruijnGraph &graph,
+                                size_t num_threads,
+                                const std::function<bool(const std::vector<node_index>&)> &index_unitig,
+                                bool replace) {
+    const uint32_t k = graph.get_k();
+    assert(sketcher_ && sketcher_->get_k() == k);
+    const size_t sketch_dim = sketcher_->dim();
+    const uint32_t n_times_sketch = params_.n_times_sketch;
+
+    // Every k-th k-mer of each unitig is sketched and indexed under the id of
+    // the node ending at its first character. The unitigs are traversed once
+    // and buffered until the batch holds enough k-mers. Then, all k-mers in
+    // the batch are sketched in parallel for all repeats into a single buffer,
+    // which is added to the index in one call.
+    std::vector<std::vector<uint8_t>> unitigs;
+    // (unitig, k-mer start) pairs and the ids to index them under
+    std::vector<std::pair<uint32_t, uint32_t>> kmers;
+    std::vector<idx_t> kmer_ids;
+
+    // nodes of the buffered unitigs, whose entries are replaced
+    std::vector<idx_t> replaced_ids;
+
+    std::vector<float> batch_sketches;
+    std::vector<idx_t> batch_ids;
+
+    uint64_t num_kmers_sketched = 0;
+    double sketching_time = 0;
+    double indexing_time = 0;
+    Timer timer;
+
+    auto sketch_batch = [&]() {
+        if (kmers.empty())
+            return;
+
+        Timer batch_timer;
+        const size_t batch_size = kmers.size() * n_times_sketch;
+        batch_sketches.resize(batch_size * sketch_dim);
+        batch_ids.resize(batch_size);
+
+        #pragma omp parallel num_threads(num_threads)
+        {
+            // thread-local scratch buffer, reused for all k-mers sketched by this thread
+            std::vector<double> scratch(sketcher_->scratch_size());
+
+            #pragma omp for schedule(dynamic, 64) collapse(2)
+            for (uint32_t n_repeat = 0; n_repeat < n_times_sketch; ++n_repeat) {
+                for (size_t i = 0; i < kmers.size(); ++i) {
+                    const auto &[unitig_id, kmer_start] = kmers[i];
+                    size_t pos = n_repeat * kmers.size() + i;
+                    sketcher_->compute_into(unitigs[unitig_id].data() + kmer_start, n_repeat,
+                                            batch_sketches.data() + pos * sketch_dim,
+                                            scratch.data());
+                    batch_ids[pos] = kmer_ids[i];
+                }
+            }
+        }
+        sketching_time += batch_timer.elapsed();
+        num_kmers_sketched += batch_size;
+
+        batch_timer.reset();
+        // quantizers and coarse clusterings are trained on the first batch,
+        // faiss parallelizes the training and the insertion internally
+        if (!index_->is_trained) {
+            logger->trace("Training the sketch index on {} sketches", batch_size);
+            index_->train(batch_size, batch_sketches.data());
+        }
+
+        if (replace && replaced_ids.size()) {
+            index_->remove_ids(faiss::IDSelectorBatch(replaced_ids.size(),
+                                                      replaced_ids.data()));
+        }
+
+        index_->add_with_ids(batch_size, batch_sketches.data(), batch_ids.data());
+        indexing_time += batch_timer.elapsed();
+
+        logger->trace("Indexed {} sketches, {} k-mers/sec sketched",
+                      num_kmers_sketched, num_kmers_sketched / sketching_time);
+
+        unitigs.clear();
+        kmers.clear();
+        kmer_ids.clear();
+        replaced_ids.clear();
+    };
+
+    // DBGSuccinct calls the unitigs from multiple threads, so the shared
+    // buffers are only modified, and the batches are only sketched and added
+    // to the index, under the lock. The unitigs are encoded before taking it.
+    std::mutex mu;
+    graph.call_unitigs([&](const std::string &s, const std::vector<node_index> &v) {
+        if (s.size() < 2 * k || !index_unitig(v))
+            return;
+
+        std::vector<uint8_t> node_to_int(s.size());
+        std::transform(s.begin(), s.end(), node_to_int.begin(),
+                       [](unsigned char c) { return ts::char2int(c); });
+
+        std::lock_guard<std::mutex> lock(mu);
+
+        if (replace)
+            replaced_ids.insert(replaced_ids.end(), v.begin(), v.end());
+
+        unitigs.push_back(std::move(node_to_int));
+
+        for (uint32_t kmer_start = k; kmer_start < s.size() - k + 1; kmer_start += k) {
+            kmers.emplace_back(unitigs.size() - 1, kmer_start);
+            kmer_ids.push_back(v[kmer_start - (k - 1)]);
+        }
+
+        if (kmers.size() >= kSketchBatchSize)
+            sketch_batch();
+    }, num_threads);
+
+    sketch_batch();
+
+    logger->trace("Sketched {} k-mers in {} sec ({} k-mers/sec), "
+                  "indexing took {} sec, total time {} sec",
+                  num_kmers_sketched, sketching_time,
+                  num_kmers_sketched / std::max(sketching_time, 1e-9),
+                  indexing_time, timer.elapsed());
+}
+
+void SketchIndex::insert_nodes(const DeBruijnGraph &graph,
+                               const bitmap &nodes_inserted,
+                               size_t num_threads) {
+    assert(index_);
+    assert(nodes_inserted.size() == graph.max_index() + 1);
+
+    if (!nodes_inserted.num_set_bits())
+        return;
+
+    size_t num_sketches = index_->ntotal;
+    Timer timer;
+
+    if (!supports_removal(index_.get())) {
+        // The entries of the updated unitigs cannot be replaced, so the index
+        // is rebuilt from scratch, keeping its search-time parameters
+        logger->trace("Sketch index of type '{}' does not support removal, rebuilding it",
+                      index_type_);
+        faiss::Index *base_index = get_base_index(index_.get());
+        size_t ef_search = kDefaultEfSearch;
+        size_t nprobe = kDefaultNprobe;
+        if (auto *hnsw = dynamic_cast<faiss::IndexHNSW*>(base_index))
+            ef_search = hnsw->hnsw.efSearch;
+        if (auto *ivf = dynamic_cast<faiss::IndexIVF*>(base_index))
+            nprobe = ivf->nprobe;
+
+        init_index();
+        set_search_params(ef_search, nprobe);
+        index_unitigs(graph, num_threads, [](const auto &) { return true; });
+
+        graph_checksum_ = graph_checksum(graph);
+
+        logger->trace("Sketch index rebuilt in {} sec, {} -> {} sketches",
+                      timer.elapsed(), num_sketches, index_->ntotal);
+        return;
+    }
+
+    auto *id_map = dynamic_cast<faiss::IndexIDMap2*>(index_.get());
+    assert(id_map);
+
+    // The j-th inserted node (0-based) is preceded by shifts[j] old nodes, so an
+    // old node i is shifted by the number of inserted nodes with shifts[j] <= i.
+    std::vector<uint64_t> shifts;
+    shifts.reserve(nodes_inserted.num_set_bits());
+    nodes_inserted.call_ones([&](uint64_t i) { shifts.push_back(i - shifts.size()); });
+
+    #pragma omp parallel for num_threads(num_threads)
+    for (size_t i = 0; i < id_map->id_map.size(); ++i) {
+        idx_t &id = id_map->id_map[i];
+        id += std::upper_bound(shifts.begin(), shifts.end(), static_cast<uint64_t>(id))
+                - shifts.begin();
+    }
+    id_map->construct_rev_map();
+
+    // re-index the unitigs with new nodes
+    index_unitigs(graph, num_threads, [&](const std::vector<node_index> &path) {
+        return std::any_of(path.begin(), path.end(),
+                           [&](node_index node) { return nodes_inserted[node]; });
+    }, true);
+
+    graph_checksum_ = graph_checksum(graph);
+
+    logger->trace("Sketch index updated in {} sec, {} -> {} sketches",
+                  timer.elapsed(), num_sketches, index_->ntotal);
+}
+
+void SketchIndex::search(size_t n, const float *x, size_t num_neighbours,
+                         float *distances, idx_t *ids) const {
+    assert(index_);
+    index_->search(n, x, num_neighbours, distances, ids);
+}
+
+void SketchIndex::set_search_params(size_t ef_search, size_t nprobe) {
+    assert(index_);
+    faiss::Index *base_index = get_base_index(index_.get());
+
+    if (auto *hnsw = dynamic_cast<faiss::IndexHNSW*>(base_index))
+        hnsw->hnsw.efSearch = ef_search;
+
+    if (auto *ivf = dynamic_cast<faiss::IndexIVF*>(base_index))
+        ivf->nprobe = std::min(nprobe, ivf->nlist);
+}
+
+auto SketchIndex::evaluate_search(const DeBruijnGraph &graph,
+                                  size_t num_queries,
+                                  size_t num_neighbours) const -> SearchStats {
+    assert(index_);
+    assert(graph.get_k() == params_.k);
+
+    SearchStats stats;
+    stats.num_neighbours = num_neighbours;
+    if (!index_->ntotal || !graph.max_index())
+        return stats;
+
+    // sketch k-mers of randomly sampled nodes
+    const size_t sketch_dim = sketcher_->dim();
+    std::vector<float> queries;
+    queries.reserve(num_queries * sketch_dim);
+    std::vector<double> scratch(sketcher_->scratch_size());
+    std::vector<uint8_t> kmer(params_.k);
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<node_index> sample_node(1, graph.max_index());
+    for (size_t i = 0; i < 100 * num_queries && stats.num_queries < num_queries; ++i) {
+        std::string sequence = graph.get_node_sequence(sample_node(gen));
+        assert(sequence.size() == kmer.size());
+        std::transform(sequence.begin(), sequence.end(), kmer.begin(),
+                       [](unsigned char c) { return ts::char2int(c); });
+        // skip dummy k-mers
+        if (std::any_of(kmer.begin(), kmer.end(),
+                        [&](uint8_t c) { return c >= params_.kmer_word_size; }))
+            continue;
+
+        queries.resize(queries.size() + sketch_dim);
+        sketcher_->compute_into(kmer.data(), stats.num_queries % params_.n_times_sketch,
+                                queries.data() + stats.num_queries * sketch_dim,
+                                scratch.data());
+        stats.num_queries++;
+    }
+
+    const size_t nq = stats.num_queries;
+    if (!nq)
+        return stats;
+
+    std::vector<float> distances(nq * num_neighbours);
+    std::vector<idx_t> ids(nq * num_neighbours);
+    std::vector<idx_t> exact_ids(nq * num_neighbours);
+
+    Timer timer;
+    index_->search(nq, queries.data(), num_neighbours, distances.data(), ids.data());
+    stats.latency_us = timer.elapsed() * 1e6 / nq;
+
+    timer.reset();
+    const faiss::Index *base_index = get_base_index(index_.get());
+    const auto *hnsw = dynamic_cast<const faiss::IndexHNSW*>(base_index);
+    const auto *ivf = dynamic_cast<const faiss::IndexIVF*>(base_index);
+    if (hnsw || ivf) {
+        if (hnsw) {
+            // the storage of HNSW is a flat index, which is searched exhaustively
+            hnsw->storage->search(nq, queries.data(), num_neighbours,
+                                  distances.data(), exact_ids.data());
+        } else {
+            // visit all inverted lists, without changing the parameters of the
+            // index, which may be searched concurrently
+            faiss::SearchParametersIVF search_params;
+            search_params.nprobe = ivf->nlist;
+            ivf->search(nq, queries.data(), num_neighbours,
+                        distances.data(), exact_ids.data(), &search_params);
+        }
+        // map the positions in the base index to the node ids
+        if (auto *id_map = dynamic_cast<const faiss::IndexIDMap2*>(index_.get())) {
+            for (idx_t &id : exact_ids) {
+                if (id >= 0)
+                    id = id_map->id_map[id];
+            }
+        }
+    } else {
+        // other indexes are searched exhaustively
+        index_->search(nq, queries.data(), num_neighbours, distances.data(), exact_ids.data());
+    }
+    stats.exact_latency_us = timer.elapsed() * 1e6 / nq;
+
+    uint64_t num_found = 0;
+    uint64_t num_exact = 0;
+    for (size_t i = 0; i < nq; ++i) {
+        auto begin = ids.begin() + i * num_neighbours;
+        auto end = begin + num_neighbours;
+        for (size_t j = i * num_neighbours; j < (i + 1) * num_neighbours; ++j) {
+            if (exact_ids[j] < 0)
+                continue;
+
+            num_exact++;
+            num_found += std::find(begin, end, exact_ids[j]) != end;
+        }
+    }
+    stats.recall = num_exact ? static_cast<double>(num_found) / num_exact : 0;
+
+    return stats;
+}
+
+uint64_t SketchIndex::graph_checksum(const SequenceGraph &graph) {
+    std::vector<uint64_t> fingerprint {
+        graph.num_nodes(),
+        graph.max_index(),
+    };
+    if (const auto *dbg = dynamic_cast<const DeBruijnGraph*>(&graph)) {
+        fingerprint.push_back(dbg->get_k());
+        fingerprint.push_back(dbg->get_mode());
+    }
+
+    // hash the sequences of the first few nodes of the graph
+    uint64_t num_nodes_hashed = 0;
+    graph.call_nodes(
+        [&](node_index node) {
+            fingerprint.push_back(node);
+            for (char c : graph.get_node_sequence(node)) {
+                fingerprint.push_back(c);
+            }
+            ++num_nodes_hashed;
+        },
+        [&]() { return num_nodes_hashed >= kNumChecksumNodes; }
+    );
+
+    return utils::VectorHash()(fingerprint);
+}
+
+bool SketchIndex::load(const std::string &filename_base, bool mmap) {
+    const auto index_filename = utils::make_suffix(filename_base, kSketchIndexExtension);
+    const auto header_filename = utils::make_suffix(index_filename, kHeaderExtension);
+
+    try {
+        std::ifstream instream(header_filename, std::ios::binary);
+        if (!instream.good())
+            return false;
+
+        uint64_t version = load_number(instream);
+        if (version != kHeaderVersion) {
+            logger->error("Unsupported version of the sketch index header {}",
+                          header_filename);
+            return false;
+        }
+        params_.k = load_number(instream);
+        params_.kmer_word_size = load_number(instream);
+        params_.embed_dim = load_number(instream);
+        params_.tuple_length = load_number(instream);
+        params_.n_times_sketch = load_number(instream);
+        graph_checksum_ = load_number(instream);
+        if (!load_string(instream, &index_type_))
+            throw std::ios_base::failure("Cannot read the index type");
+
+        // Map the index instead of reading it into memory, so that the pages
+        // are shared between processes using the same index. faiss maps only
+        // the inverted lists of IVF indexes, everything else is read into memory.
+        index_.reset(faiss::read_index(index_filename.c_str(),
+                                       mmap ? faiss::IO_FLAG_MMAP | faiss::IO_FLAG_READ_ONLY
+                                            : 0));
+
+        if (mmap && !dynamic_cast<faiss::IndexIVF*>(get_base_index(index_.get()))) {
+            logger->warn("Sketch index of type '{}' cannot be memory-mapped and was "
+                         "loaded into memory. Use an IVF index to keep it on disk.",
+                         index_type_);
+        }
+
+    } catch (...) {
+        logger->error("Cannot load sketch index from {}", index_filename);
+        return false;
+    }
+
+    sketcher_ = std::make_shared<ts::KmerSketcher>(params_.kmer_word_size, params_.embed_dim,
+                                                   params_.tuple_length, params_.k,
+                                                   params_.n_times_sketch);
+    return true;
+}
+
+void SketchIndex::serialize(const std::string &filename_base) const {
+    assert(index_);
+    const auto index_filename = utils::make_suffix(filename_base, kSketchIndexExtension);
+    const auto header_filename = utils::make_suffix(index_filename, kHeaderExtension);
+
+    std::ofstream outstream(header_filename, std::ios::binary);
+    serialize_number(outstream, kHeaderVersion);
+    serialize_number(outstream, params_.k);
+    serialize_number(outstream, params_.kmer_word_size);
+    serialize_number(outstream, params_.embed_dim);
+    serialize_number(outstream, params_.tuple_length);
+    serialize_number(outstream, params_.n_times_sketch);
+    serialize_number(outstream, graph_checksum_);
+    serialize_string(outstream, index_type_);
+
+    faiss::write_index(index_.get(), index_filename.c_str());
+}
+
+bool SketchIndex::is_compatible(const SequenceGraph &graph, bool verbose) const {
+    if (graph_checksum(graph) == graph_checksum_)
+        return true;
+
+    if (verbose)
+        logger->error("Sketch index was not built from this graph");
+    return false;
+}
+
+bool SketchIndex::is_compatible(const SequenceGraph &graph,
+                                const Params &params,
+                                bool verbose) const {
+    if (!is_compatible(graph, verbose))
+        return false;
+
+    if (params == params_)
+        return true;
+
+    if (verbose) {
+        logger->error("Sketch index was built with different parameters: "
+                      "k={}, kmer_word_size={}, embed_dim={}, tuple_length={}, "
+                      "n_times_sketch={}", params_.k, params_.kmer_word_size,
+                      params_.embed_dim, params_.tuple_length, params_.n_times_sketch);
+    }
+    return false;
+}
+
+} // namespace graph
+} // namespace mtg
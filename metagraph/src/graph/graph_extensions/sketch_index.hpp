@@ -0,0 +1,147 @@
+#ifndef __SKETCH_INDEX_HPP__
+#define __SKETCH_INDEX_HPP__
+
+#include <memory>
+#include <string>
+
+#include <faiss/Index.h>
+
+#include "graph/representation/base/sequence_graph.hpp"
+#include "common/vectors/bitmap.hpp"
+#include "sketch/kmer_sketcher.hpp"
+
+
+namespace mtg {
+namespace graph {
+
+// Nearest neighbour index over tensor sketches of the k-mers of a DeBruijnGraph.
+// Every k-th k-mer of each unitig (of length at least 2k) is sketched with all
+// repeats of a ts::KmerSketcher and indexed under the id of the node ending at
+// the first character of the k-mer.
+//
+// The index is stored in two files: a header with the sketching parameters and a
+// checksum of the graph, which is checked when the index is loaded, and the faiss
+// index itself.
+//
+// The type of the index is given by a faiss index factory string, e.g.
+//   "HNSW32"           HNSW graph over full-precision sketches (default)
+//   "HNSW32_SQ8"       HNSW graph over sketches quantized to 8 bits per component
+//   "IVF4096,PQ16"     inverted file with product quantized sketches (16 bytes each)
+//   "IVF4096,SQ8"      inverted file with scalar quantized sketches
+// Only the inverted lists of IVF indexes are memory-mapped from disk when loaded,
+// so these can be used as on-disk indexes. HNSW indexes are always loaded into
+// memory.
+class SketchIndex : public SequenceGraph::GraphExtension {
+  public:
+    using node_index = typename SequenceGraph::node_index;
+
+    static constexpr auto kDefaultIndexType = "HNSW32";
+
+    struct Params {
+        uint32_t k = 0;
+        uint64_t kmer_word_size = 0;
+        uint64_t embed_dim = 0;
+        uint64_t tuple_length = 0;
+        uint32_t n_times_sketch = 0;
+
+        bool operator==(const Params &other) const {
+            return k == other.k && kmer_word_size == other.kmer_word_size
+                    && embed_dim == other.embed_dim && tuple_length == other.tuple_length
+                    && n_times_sketch == other.n_times_sketch;
+        }
+        bool operator!=(const Params &other) const { return !(*this == other); }
+    };
+
+    // Statistics of the approximate nearest neighbour search
+    struct SearchStats {
+        size_t num_queries = 0;
+        size_t num_neighbours = 0;
+        // fraction of the true nearest neighbours found by the approximate search
+        double recall = 0;
+        // search time per query, in microseconds
+        double latency_us = 0;
+        double exact_latency_us = 0;
+    };
+
+    SketchIndex() {}
+    // Sketch the k-mers of |graph| and build an index of type |index_type|.
+    // params.k must match graph.get_k().
+    SketchIndex(const DeBruijnGraph &graph,
+                const Params &params,
+                const std::string &index_type = kDefaultIndexType,
+                size_t num_threads = 1);
+
+    const Params& get_params() const { return params_; }
+    const std::string& get_index_type() const { return index_type_; }
+    const ts::KmerSketcher& get_sketcher() const { assert(sketcher_); return *sketcher_; }
+    uint64_t num_sketches() const { return index_ ? index_->ntotal : 0; }
+
+    // Set the search-time parameters: the size of the candidate list in HNSW
+    // and the number of inverted lists visited in IVF indexes. Must not be
+    // called concurrently with search.
+    void set_search_params(size_t ef_search, size_t nprobe);
+
+    // Query |n| sketches stored in |x| and return the ids and the distances of
+    // their |num_neighbours| nearest neighbours in |ids| and |distances|
+    void search(size_t n, const float *x, size_t num_neighbours,
+                float *distances, idx_t *ids) const;
+
+    // Update the index after the nodes marked in |nodes_inserted| were added to
+    // |graph|. The ids of the indexed nodes are shifted accordingly, and only the
+    // unitigs containing new nodes are sketched and indexed again. Indexes which
+    // do not support removal of entries (e.g., HNSW) are rebuilt from scratch.
+    // The index must be loaded with mmap disabled.
+    void insert_nodes(const DeBruijnGraph &graph,
+                      const bitmap &nodes_inserted,
+                      size_t num_threads = 1);
+
+    // Load the index, memory-mapping it if |mmap| is true and the index is an
+    // IVF index. Other index types are read into memory with a warning.
+    bool load(const std::string &filename_base, bool mmap);
+    bool load(const std::string &filename_base) { return load(filename_base, true); }
+    void serialize(const std::string &filename_base) const;
+
+    // Check if the index was built from |graph|
+    bool is_compatible(const SequenceGraph &graph, bool verbose = true) const;
+    // Check if the index was built from |graph| with sketching parameters |params|
+    bool is_compatible(const SequenceGraph &graph, const Params &params,
+                       bool verbose = true) const;
+
+    // Fingerprint of the graph topology stored in the index header
+    static uint64_t graph_checksum(const SequenceGraph &graph);
+
+    // Sketch |num_queries| k-mers sampled from |graph| and compare the results of
+    // the search with the results of an exhaustive search over all sketches stored
+    // in the index. For quantized indexes, the exhaustive search is run on the
+    // quantized sketches.
+    SearchStats evaluate_search(const DeBruijnGraph &graph,
+                                size_t num_queries,
+                                size_t num_neighbours) const;
+
+  private:
+    // Construct an empty index of type |index_type_|
+    void init_index();
+
+    // Sketch the sampled k-mers of all unitigs of |graph| for which |index_unitig|
+    // returns true and add them to the index. If |replace| is true, the entries of
+    // the nodes of these unitigs are removed from the index first.
+    void index_unitigs(const DeBruijnGraph &graph,
+                       size_t num_threads,
+                       const std::function<bool(const std::vector<node_index>&)> &index_unitig,
+                       bool replace = false);
+
+    Params params_;
+    std::string index_type_;
+    uint64_t graph_checksum_ = 0;
+
+    std::shared_ptr<const ts::KmerSketcher> sketcher_;
+    std::shared_ptr<faiss::Index> index_;
+
+    static constexpr auto kSketchIndexExtension = ".sketch_index";
+    static constexpr auto kHeaderExtension = ".header";
+};
+
+} // namespace graph
+} // namespace mtg
+
+#endif // __SKETCH_INDEX_HPP__
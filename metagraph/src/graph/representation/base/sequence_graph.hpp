@@ -71,6 +71,15 @@ class SequenceGraph {
                                            const std::function<void(node_index)> &callback,
                                            const std::function<bool()> &terminate = [](){ return false; }) const = 0;
 
+    // Map each of |sequences| to the graph nodes in the same way as map_to_nodes
+    // and map_to_nodes_sequentially. The i-th vector holds the nodes of the i-th
+    // sequence. Representations that can interleave the lookups for different
+    // sequences to hide the memory latency override these.
+    virtual std::vector<std::vector<node_index>>
+    map_to_nodes_batch(const std::vector<std::string_view> &sequences) const;
+    virtual std::vector<std::vector<node_index>>
+    map_to_nodes_sequentially_batch(const std::vector<std::string_view> &sequences) const;
+
     // Given a node index, call the target nodes of all edges outgoing from it.
     virtual void adjacent_outgoing_nodes(node_index node,
                                          const std::function<void(node_index)> &callback) const = 0;
@@ -174,19 +183,7 @@ class DeBruijnGraph : public SequenceGraph {
 
 //    using key_type = boost::multiprecision::uint256_t;
     using key_type = uint64_t;
-    virtual void compute_sketches(uint64_t kmer_word_size,
-                                  size_t embed_dim,
-                                  size_t tuple_length,
-                                  uint32_t n_times_sketch,
-                                  uint32_t num_threads,
-				  const char* fname,
-				  bool load_index);
     mutable std::unordered_map<node_index, node_index> debugmap;
-    /* faiss::IndexHNSWSQ *index_; */
-    faiss::IndexHNSW *index_;
-    faiss::IndexIDMap2 *index;
-    /* faiss::IndexHNSWFlat *quantizer; */
-    /* faiss::IndexIVFFlat *index; */
     // Returns a map from tmer to the node_index
     // node_index corresponds to the node where the tmer starts at
     // n is the number of tmers
@@ -43,6 +43,12 @@ CanonicalDBG::CanonicalDBG(std::shared_ptr<const DeBruijnGraph> graph, size_t ca
     } else {
         add_extension(std::make_shared<NodeRC>(*graph_));
     }
+
+    // share the precomputed first characters, they are safe to query concurrently
+    if (auto cache = graph_->get_extension<NodeFirstCache>()) {
+        if (cache->is_indexed())
+            add_extension(cache);
+    }
 }
 
 void CanonicalDBG
@@ -0,0 +1,256 @@
+#include "dbg_hash_mphf.hpp"
+
+#include <cassert>
+#include <algorithm>
+#include <fstream>
+#include <type_traits>
+
+#include "common/serialization.hpp"
+#include "common/utils/file_utils.hpp"
+#include "common/utils/string_utils.hpp"
+#include "common/logger.hpp"
+
+
+namespace mtg {
+namespace graph {
+
+using mtg::common::logger;
+using mtg::common::MinimalPerfectHash;
+
+// distinct from the seeds used by the levels of the minimal perfect hash
+constexpr uint64_t kFingerprintSeed = 0xf1f1;
+
+
+DBGHashMPHF::DBGHashMPHF(size_t k, Mode mode) : k_(k), mode_(mode) {
+    if (k < 1 || k > 256 / KmerExtractor::bits_per_char) {
+        logger->error("For hash graph, k must be between 1 and {}",
+                      256 / KmerExtractor::bits_per_char);
+        exit(1);
+    }
+}
+
+DBGHashMPHF::DBGHashMPHF(const DeBruijnGraph &graph,
+                         uint8_t fingerprint_bits,
+                         size_t num_threads)
+      : DBGHashMPHF(graph.get_k(), graph.get_mode()) {
+    if (fingerprint_bits < 1 || fingerprint_bits > 64) {
+        logger->error("The number of fingerprint bits must be between 1 and 64");
+        exit(1);
+    }
+
+    const size_t alph_size = seq_encoder_.alphabet.size();
+
+    std::vector<uint64_t> keys;
+    // (mask of incoming edges << alph_size) | mask of outgoing edges
+    std::vector<uint64_t> edges;
+    keys.reserve(graph.num_nodes());
+    edges.reserve(graph.num_nodes());
+
+    call_with_kmer_type([&](auto kmer_type) {
+        using Kmer = decltype(kmer_type);
+
+        graph.call_kmers([&](node_index node, const std::string &kmer) {
+            auto kmers = seq_encoder_.sequence_to_kmers<Kmer>(kmer, k_);
+            assert(kmers.size() == 1);
+            if (!kmers[0].second)
+                return;
+
+            uint64_t mask = 0;
+            graph.call_outgoing_kmers(node, [&](node_index, char c) {
+                auto code = seq_encoder_.encode(c);
+                if (code < alph_size)
+                    mask |= 1llu << code;
+            });
+            graph.call_incoming_kmers(node, [&](node_index, char c) {
+                auto code = seq_encoder_.encode(c);
+                if (code < alph_size)
+                    mask |= 1llu << (alph_size + code);
+            });
+
+            keys.push_back(get_key(kmers[0].first));
+            edges.push_back(mask);
+        });
+    });
+
+    std::vector<uint64_t> distinct_keys = keys;
+    std::sort(distinct_keys.begin(), distinct_keys.end());
+    distinct_keys.erase(std::unique(distinct_keys.begin(), distinct_keys.end()),
+                        distinct_keys.end());
+
+    // only possible if k-mers longer than 64 bits are folded into the same key
+    if (distinct_keys.size() < keys.size()) {
+        logger->warn("{} k-mers share their hash keys and will be merged",
+                     keys.size() - distinct_keys.size());
+    }
+
+    mphf_ = MinimalPerfectHash(std::move(distinct_keys), 2, num_threads);
+
+    fingerprints_ = sdsl::int_vector<>(mphf_.size(), 0, fingerprint_bits);
+    edges_ = sdsl::int_vector<>(mphf_.size(), 0, 2 * alph_size);
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        uint64_t index = mphf_(keys[i]);
+        assert(index < mphf_.size());
+
+        fingerprints_[index] = get_fingerprint(keys[i]);
+        edges_[index] = edges_[index] | edges[i];
+    }
+}
+
+template <class Callback>
+void DBGHashMPHF::call_with_kmer_type(const Callback &callback) const {
+    if (k_ * KmerExtractor::bits_per_char <= 64) {
+        callback(KmerExtractor::Kmer64());
+    } else if (k_ * KmerExtractor::bits_per_char <= 128) {
+        callback(KmerExtractor::Kmer128());
+    } else {
+        callback(KmerExtractor::Kmer256());
+    }
+}
+
+template <class Kmer>
+uint64_t DBGHashMPHF::get_key(const Kmer &kmer) const {
+    if constexpr(std::is_same_v<typename Kmer::WordType, uint64_t>) {
+        return kmer.data();
+
+    } else {
+        // fold longer k-mers into a single 64-bit key
+        const size_t num_words = (k_ * Kmer::kBitsPerChar + 63) / 64;
+        uint64_t key = 0;
+        for (size_t i = 0; i < num_words; ++i) {
+            uint64_t word = static_cast<uint64_t>(kmer.data() >> static_cast<int>(64 * i));
+            key = MinimalPerfectHash::hash(key ^ word, i);
+        }
+        return key;
+    }
+}
+
+uint64_t DBGHashMPHF::get_fingerprint(uint64_t key) const {
+    return MinimalPerfectHash::hash(key, kFingerprintSeed) >> (64 - fingerprints_.width());
+}
+
+DBGHashMPHF::node_index DBGHashMPHF::get_node_index(uint64_t key) const {
+    uint64_t index = mphf_(key);
+
+    if (index >= mphf_.size() || fingerprints_[index] != get_fingerprint(key))
+        return npos;
+
+    return index + 1;
+}
+
+void DBGHashMPHF::map_kmers(std::string_view sequence,
+                            bool canonical,
+                            const std::function<void(node_index)> &callback,
+                            const std::function<bool()> &terminate) const {
+    call_with_kmer_type([&](auto kmer_type) {
+        using Kmer = decltype(kmer_type);
+
+        for (const auto &[kmer, is_valid]
+                : seq_encoder_.sequence_to_kmers<Kmer>(sequence, k_, canonical)) {
+            if (terminate())
+                return;
+
+            callback(is_valid ? get_node_index(get_key(kmer)) : npos);
+        }
+    });
+}
+
+// Traverse graph mapping sequence to the graph nodes
+// and run callback for each node until the termination condition is satisfied
+void DBGHashMPHF::map_to_nodes(std::string_view sequence,
+                               const std::function<void(node_index)> &callback,
+                               const std::function<bool()> &terminate) const {
+    map_kmers(sequence, mode_ == CANONICAL, callback, terminate);
+}
+
+// Traverse graph mapping sequence to the graph nodes
+// and run callback for each node until the termination condition is satisfied.
+// Guarantees that nodes are called in the same order as the input sequence.
+// In canonical mode, non-canonical k-mers are NOT mapped to canonical ones
+void DBGHashMPHF::map_to_nodes_sequentially(std::string_view sequence,
+                                            const std::function<void(node_index)> &callback,
+                                            const std::function<bool()> &terminate) const {
+    map_kmers(sequence, false, callback, terminate);
+}
+
+void DBGHashMPHF::call_nodes(const std::function<void(node_index)> &callback,
+                             const std::function<bool()> &stop_early) const {
+    for (node_index node = 1; node <= num_nodes() && !stop_early(); ++node) {
+        callback(node);
+    }
+}
+
+size_t DBGHashMPHF::outdegree(node_index node) const {
+    assert(node > 0 && node <= num_nodes());
+
+    uint64_t outgoing_mask = (1llu << seq_encoder_.alphabet.size()) - 1;
+    return sdsl::bits::cnt(edges_[node - 1] & outgoing_mask);
+}
+
+size_t DBGHashMPHF::indegree(node_index node) const {
+    assert(node > 0 && node <= num_nodes());
+
+    return sdsl::bits::cnt(edges_[node - 1] >> seq_encoder_.alphabet.size());
+}
+
+void DBGHashMPHF::serialize(std::ostream &out) const {
+    if (!out.good())
+        throw std::ofstream::failure("Error when dumping graph");
+
+    serialize_number(out, k_);
+    serialize_number(out, static_cast<int>(mode_));
+    mphf_.serialize(out);
+    fingerprints_.serialize(out);
+    edges_.serialize(out);
+}
+
+void DBGHashMPHF::serialize(const std::string &filename) const {
+    std::ofstream out(utils::make_suffix(filename, kExtension), std::ios::binary);
+    serialize(out);
+}
+
+bool DBGHashMPHF::load(std::istream &in) {
+    if (!in.good())
+        return false;
+
+    try {
+        k_ = load_number(in);
+        mode_ = static_cast<Mode>(load_number(in));
+
+        if (!mphf_.load(in))
+            return false;
+
+        fingerprints_.load(in);
+        edges_.load(in);
+
+        return in.good()
+                && fingerprints_.size() == mphf_.size()
+                && edges_.size() == mphf_.size();
+
+    } catch (...) {
+        return false;
+    }
+}
+
+bool DBGHashMPHF::load(const std::string &filename) {
+    std::ifstream in(utils::make_suffix(filename, kExtension), std::ios::binary);
+    return load(in);
+}
+
+bool DBGHashMPHF::operator==(const DeBruijnGraph &other) const {
+    if (this == &other)
+        return true;
+
+    const auto *other_mphf = dynamic_cast<const DBGHashMPHF*>(&other);
+    if (!other_mphf)
+        throw std::runtime_error("Not implemented");
+
+    // the same index built from the same k-mers
+    return k_ == other_mphf->k_
+            && mode_ == other_mphf->mode_
+            && fingerprints_ == other_mphf->fingerprints_
+            && edges_ == other_mphf->edges_;
+}
+
+} // namespace graph
+} // namespace mtg
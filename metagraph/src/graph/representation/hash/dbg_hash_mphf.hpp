@@ -0,0 +1,148 @@
+#ifndef __DBG_HASH_MPHF_HPP__
+#define __DBG_HASH_MPHF_HPP__
+
+#include <iostream>
+
+#include <sdsl/int_vector.hpp>
+
+#include "graph/representation/base/sequence_graph.hpp"
+#include "common/hashers/mphf.hpp"
+#include "kmer/kmer_extractor.hpp"
+
+
+namespace mtg {
+namespace graph {
+
+/**
+ * A static hash-based de Bruijn graph, constructed from another graph.
+ *
+ * The k-mers are indexed with a minimal perfect hash function and are not stored.
+ * Instead, each node keeps a fingerprint of its k-mer, with which k-mers missing
+ * from the graph are rejected with probability 1 - 2^{-fingerprint_bits}, and the
+ * masks of its incoming and outgoing edges. For DNA and 16-bit fingerprints, this
+ * takes about 3.5 bytes per k-mer.
+ *
+ * Since the node sequences are not stored, the graph supports mapping sequences
+ * to nodes and node degree queries, but not traversals.
+ */
+class DBGHashMPHF : public DeBruijnGraph {
+  public:
+    explicit DBGHashMPHF(size_t k, Mode mode = BASIC);
+
+    // Index all k-mers of |graph|
+    explicit DBGHashMPHF(const DeBruijnGraph &graph,
+                         uint8_t fingerprint_bits = kDefaultFingerprintBits,
+                         size_t num_threads = 1);
+
+    // The graph is static, so sequences cannot be inserted
+    void add_sequence(std::string_view,
+                      const std::function<void(node_index)> & = [](node_index) {}) {
+        throw std::runtime_error("Not implemented");
+    }
+
+    // Traverse graph mapping sequence to the graph nodes
+    // and run callback for each node until the termination condition is satisfied
+    void map_to_nodes(std::string_view sequence,
+                      const std::function<void(node_index)> &callback,
+                      const std::function<bool()> &terminate = [](){ return false; }) const;
+
+    // Traverse graph mapping sequence to the graph nodes
+    // and run callback for each node until the termination condition is satisfied.
+    // Guarantees that nodes are called in the same order as the input sequence.
+    // In canonical mode, non-canonical k-mers are NOT mapped to canonical ones
+    void map_to_nodes_sequentially(std::string_view sequence,
+                                   const std::function<void(node_index)> &callback,
+                                   const std::function<bool()> &terminate = [](){ return false; }) const;
+
+    void call_nodes(const std::function<void(node_index)> &callback,
+                    const std::function<bool()> &stop_early = [](){ return false; }) const;
+
+    void call_outgoing_kmers(node_index, const OutgoingEdgeCallback &) const {
+        throw std::runtime_error("Not implemented");
+    }
+
+    void call_incoming_kmers(node_index, const IncomingEdgeCallback &) const {
+        throw std::runtime_error("Not implemented");
+    }
+
+    node_index traverse(node_index, char) const {
+        throw std::runtime_error("Not implemented");
+    }
+
+    node_index traverse_back(node_index, char) const {
+        throw std::runtime_error("Not implemented");
+    }
+
+    void adjacent_outgoing_nodes(node_index, const std::function<void(node_index)> &) const {
+        throw std::runtime_error("Not implemented");
+    }
+
+    void adjacent_incoming_nodes(node_index, const std::function<void(node_index)> &) const {
+        throw std::runtime_error("Not implemented");
+    }
+
+    size_t outdegree(node_index node) const;
+    size_t indegree(node_index node) const;
+
+    std::string get_node_sequence(node_index) const {
+        throw std::runtime_error("Not implemented");
+    }
+
+    size_t get_k() const { return k_; }
+    Mode get_mode() const { return mode_; }
+
+    uint64_t num_nodes() const { return mphf_.size(); }
+
+    uint8_t get_fingerprint_bits() const { return fingerprints_.width(); }
+
+    void serialize(std::ostream &out) const;
+    void serialize(const std::string &filename) const;
+
+    bool load(std::istream &in);
+    bool load(const std::string &filename);
+
+    std::string file_extension() const { return kExtension; }
+
+    bool operator==(const DeBruijnGraph &other) const;
+
+    const std::string& alphabet() const { return seq_encoder_.alphabet; }
+
+    static constexpr auto kExtension = ".hashmphfdbg";
+    static constexpr uint8_t kDefaultFingerprintBits = 16;
+
+  private:
+    using KmerExtractor = kmer::KmerExtractor2Bit;
+
+    // call |callback| with an empty k-mer of the type used for this k
+    template <class Callback>
+    void call_with_kmer_type(const Callback &callback) const;
+
+    template <class Kmer>
+    uint64_t get_key(const Kmer &kmer) const;
+
+    void map_kmers(std::string_view sequence,
+                   bool canonical,
+                   const std::function<void(node_index)> &callback,
+                   const std::function<bool()> &terminate) const;
+
+    // returns npos if the k-mer is not in the graph
+    node_index get_node_index(uint64_t key) const;
+
+    uint64_t get_fingerprint(uint64_t key) const;
+
+    size_t k_;
+    Mode mode_;
+
+    common::MinimalPerfectHash mphf_;
+    // the fingerprints of the k-mers, indexed by node_index - 1
+    sdsl::int_vector<> fingerprints_;
+    // (mask of incoming edges << alphabet size) | mask of outgoing edges
+    sdsl::int_vector<> edges_;
+
+    KmerExtractor seq_encoder_;
+};
+
+} // namespace graph
+} // namespace mtg
+
+#endif // __DBG_HASH_MPHF_HPP__
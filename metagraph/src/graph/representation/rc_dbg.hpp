@@ -19,8 +19,14 @@ class RCDBG : public DBGWrapper<DeBruijnGraph> {
   public:
     template <typename... Args>
     RCDBG(Args&&... args) : DBGWrapper<DeBruijnGraph>(std::forward<Args>(args)...) {
-        if (const auto *dbg_succ = dynamic_cast<const DBGSuccinct*>(graph_.get()))
-            add_extension(std::make_shared<NodeFirstCache>(*dbg_succ));
+        if (const auto *dbg_succ = dynamic_cast<const DBGSuccinct*>(graph_.get())) {
+            auto cache = dbg_succ->get_extension<NodeFirstCache>();
+            if (cache && cache->is_indexed()) {
+                add_extension(cache);
+            } else {
+                add_extension(std::make_shared<NodeFirstCache>(*dbg_succ));
+            }
+        }
     }
 
     virtual node_index traverse(node_index node, char next_char) const override final {
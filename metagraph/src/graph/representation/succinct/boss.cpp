@@ -5,11 +5,14 @@
 #include <cstdio>
 
 #include <algorithm>
+#include <future>
+#include <mutex>
 #include <optional>
 #include <stack>
 #include <string>
 #include <vector>
 
+#include <ips4o.hpp>
 #include <progress_bar.hpp>
 #include <tsl/hopscotch_set.h>
 
@@ -22,7 +25,10 @@
 #include "common/vectors/bit_vector_sdsl.hpp"
 #include "common/vectors/bit_vector_dyn.hpp"
 #include "common/vectors/bit_vector_adaptive.hpp"
+#include "common/vectors/bit_vector_sd.hpp"
 #include "boss_construct.hpp"
+#include "boss_merge.hpp"
+#include "boss_interleaved.hpp"
 
 
 namespace mtg {
@@ -300,6 +306,14 @@ void BOSS::serialize(Chunk&& chunk, std::ofstream &out, State state) {
             SERIALIZE_W(wavelet_tree_small);
             SERIALIZE_LAST(bit_vector_small);
             break;
+        case State::INTERLEAVED: {
+            // the last array is serialized together with W
+            sdsl::int_vector<> W = to_vector(chunk.W_);
+            chunk.W_.close(true);
+            BOSSInterleavedTable(chunk.get_W_width(), W, to_vector(chunk.last_)).serialize(out);
+            chunk.last_.close(true);
+            break;
+        }
     }
 
     out.flush();
@@ -348,6 +362,13 @@ bool BOSS::load(std::ifstream &instream) {
                 W_ = new wavelet_tree_small(bits_per_char_W_);
                 last_ = new bit_vector_small();
                 break;
+            case State::INTERLEAVED: {
+                // loaded with W, the load of last is a no-op
+                auto table = std::make_shared<BOSSInterleavedTable>();
+                W_ = new wavelet_tree_interleaved(table);
+                last_ = new bit_vector_interleaved(table);
+                break;
+            }
         }
         if (!W_->load(instream)) {
             std::cerr << "ERROR: failed to load W vector" << std::endl;
@@ -371,8 +392,19 @@ bool BOSS::load(std::ifstream &instream) {
     }
 }
 
+// Marks the serialized suffix length of the sparse index of node ranges
+static constexpr uint64_t kSparseSuffixIndexFlag = 1ull << 63;
+
 void BOSS::serialize_suffix_ranges(std::ofstream &outstream) const {
     // dump node range index
+    if (sparse_suffixes_) {
+        serialize_number(outstream, indexed_suffix_length_ | kSparseSuffixIndexFlag);
+        sparse_suffixes_->serialize(outstream);
+        sparse_suffix_begins_->serialize(outstream);
+        sparse_suffix_ends_->serialize(outstream);
+        return;
+    }
+
     serialize_number(outstream, indexed_suffix_length_);
 
     outstream.write(reinterpret_cast<const char *>(indexed_suffix_ranges_.data()),
@@ -384,11 +416,28 @@ bool BOSS::load_suffix_ranges(std::ifstream &instream) {
     // load node suffix range index if exists
     try {
         indexed_suffix_length_ = load_number(instream);
+        bool sparse = indexed_suffix_length_ & kSparseSuffixIndexFlag;
+        indexed_suffix_length_ &= ~kSparseSuffixIndexFlag;
+
         if (!indexed_suffix_length_
                 || indexed_suffix_length_ > k_
                 || indexed_suffix_length_ * log2(alph_size - 1) > 63)
             throw std::ifstream::failure("");
 
+        if (sparse) {
+            sparse_suffixes_ = std::make_unique<bit_vector_sd>();
+            sparse_suffix_begins_ = std::make_unique<bit_vector_sd>();
+            sparse_suffix_ends_ = std::make_unique<bit_vector_sd>();
+            if (!sparse_suffixes_->load(instream)
+                    || !sparse_suffix_begins_->load(instream)
+                    || !sparse_suffix_ends_->load(instream)
+                    || sparse_suffix_begins_->size() != W_->size()
+                    || sparse_suffix_ends_->size() != W_->size())
+                throw std::ifstream::failure("");
+
+            return true;
+        }
+
         uint64_t index_size = 1;
         for (size_t len = 1; len <= indexed_suffix_length_; ++len) {
             index_size *= (alph_size - 1);
@@ -408,6 +457,9 @@ bool BOSS::load_suffix_ranges(std::ifstream &instream) {
     } catch(...) {
         indexed_suffix_length_ = 0;
         indexed_suffix_ranges_.clear();
+        sparse_suffixes_.reset();
+        sparse_suffix_begins_.reset();
+        sparse_suffix_ends_.reset();
         return false;
     }
 }
@@ -930,16 +982,31 @@ std::vector<TAlphabet> BOSS::get_node_seq(edge_index x) const {
             x = bwd(x);
         }
 
-        auto it = std::lower_bound(
-            indexed_suffix_ranges_.begin(),
-            indexed_suffix_ranges_.end(),
-            x,
-            [](const auto &range, edge_index edge) { return (range.second < edge); }
-        );
+        // the index of the suffix of length |indexed_suffix_length_|, if indexed
+        std::optional<uint64_t> suffix_index;
+
+        if (sparse_suffixes_) {
+            // the last range starting not after |x|
+            if (uint64_t rank = sparse_suffix_begins_->rank1(x)) {
+                if (sparse_suffix_ends_->select1(rank) >= x)
+                    suffix_index = sparse_suffixes_->select1(rank);
+            }
+        } else {
+            auto it = std::lower_bound(
+                indexed_suffix_ranges_.begin(),
+                indexed_suffix_ranges_.end(),
+                x,
+                [](const auto &range, edge_index edge) { return (range.second < edge); }
+            );
+
+            if (it != indexed_suffix_ranges_.end() && it->first <= x) {
+                assert(x <= it->second);
+                suffix_index = it - indexed_suffix_ranges_.begin();
+            }
+        }
 
-        if (it != indexed_suffix_ranges_.end() && it->first <= x) {
-            assert(x <= it->second);
-            uint64_t index = it - indexed_suffix_ranges_.begin();
+        if (suffix_index) {
+            uint64_t index = *suffix_index;
             for (i = 0; i < indexed_suffix_length_; ++i) {
                 uint64_t next_index = index / (alph_size - 1);
                 ret[i] = index - next_index * (alph_size - 1) + 1;
@@ -1041,6 +1108,197 @@ BOSS::map_to_edges(const std::vector<TAlphabet> &seq_encoded) const {
     return indices;
 }
 
+void BOSS::map_to_edges_with_rc(const std::vector<TAlphabet> &seq_encoded,
+                                const std::vector<TAlphabet> &complement,
+                                const std::function<void(edge_index, edge_index)> &callback,
+                                const std::function<bool()> &terminate) const {
+    assert(std::all_of(seq_encoded.begin(), seq_encoded.end(),
+                       [this](TAlphabet c) { return c <= alph_size; }));
+    assert(complement.size() > alph_size);
+
+    if (seq_encoded.size() <= k_)
+        return;
+
+    auto invalid = utils::drag_and_mark_segments(seq_encoded, alph_size, k_ + 1);
+
+    // buffer for the reverse complement (k+1)-mer searched from scratch
+    std::vector<TAlphabet> rc_kmer(k_ + 1);
+
+    edge_index edge = npos;
+    edge_index rc_edge = npos;
+
+    for (size_t i = 0; i + k_ + 1 <= seq_encoded.size() && !terminate(); ++i) {
+        if (invalid[i + k_]) {
+            // this (k+1)-mer contains at least one invalid character
+            edge = rc_edge = npos;
+            callback(npos, npos);
+            continue;
+        }
+
+        edge = edge ? pick_edge(fwd(edge, seq_encoded[i + k_ - 1]), seq_encoded[i + k_])
+                    : map_to_edge(seq_encoded.data() + i,
+                                  seq_encoded.data() + i + k_ + 1);
+
+        if (!edge) {
+            // the reverse complement is missing as well
+            rc_edge = npos;
+            callback(npos, npos);
+            continue;
+        }
+
+        if (rc_edge) {
+            // The reverse complement (k+1)-mer is incoming to the source node of
+            // the previous one. It exists since its forward (k+1)-mer exists, hence,
+            // it's the first incoming edge if that is the only one.
+            edge_index first_incoming = bwd(rc_edge);
+            rc_edge = is_single_incoming(first_incoming, get_W(first_incoming))
+                        ? first_incoming
+                        : npos;
+        }
+
+        if (!rc_edge) {
+            // restart the search on the reverse complement strand
+            for (size_t j = 0; j <= k_; ++j) {
+                rc_kmer[j] = complement[seq_encoded[i + k_ - j]];
+            }
+            rc_edge = map_to_edge(rc_kmer.begin(), rc_kmer.end());
+        }
+
+        callback(edge, rc_edge);
+    }
+}
+
+// The number of searches advanced in lock-step by map_to_edges_batch
+static constexpr size_t kNumInterleavedSearches = 16;
+// Sequences are split into segments of this many (k+1)-mers, so that a single
+// long sequence also gives enough independent searches. Each segment starts
+// with a search from scratch, which takes k steps instead of a single fwd.
+static constexpr size_t kMapSegmentLength = 256;
+
+std::vector<std::vector<edge_index>>
+BOSS::map_to_edges_batch(const std::vector<std::string_view> &sequences) const {
+    std::vector<std::vector<edge_index>> edges(sequences.size());
+    std::vector<std::vector<TAlphabet>> encoded(sequences.size());
+    std::vector<std::vector<bool>> invalid(sequences.size());
+
+    // a segment of (k+1)-mers [begin, end) of the sequence |seq_id|
+    struct Search {
+        size_t seq_id;
+        size_t i;
+        size_t end;
+        // the edge of the previous (k+1)-mer, if it was found
+        edge_index edge = 0;
+        // range of the search from scratch and the next character to match
+        bool searching = false;
+        edge_index rl = 0;
+        edge_index ru = 0;
+        size_t pos = 0;
+    };
+    std::vector<Search> searches;
+
+    for (size_t s = 0; s < sequences.size(); ++s) {
+        if (sequences[s].size() <= k_)
+            continue;
+
+        encoded[s] = encode(sequences[s]);
+        assert(std::all_of(encoded[s].begin(), encoded[s].end(),
+                           [this](TAlphabet c) { return c <= alph_size; }));
+        invalid[s] = utils::drag_and_mark_segments(encoded[s], alph_size, k_ + 1);
+
+        const size_t num_kmers = encoded[s].size() - k_;
+        edges[s].resize(num_kmers);
+        for (size_t begin = 0; begin < num_kmers; begin += kMapSegmentLength) {
+            searches.push_back({ s, begin, std::min(begin + kMapSegmentLength, num_kmers) });
+        }
+    }
+
+    // Make one step of the search and prefetch the data needed for the next one.
+    // Returns false when all (k+1)-mers of the segment are mapped.
+    auto step = [&](Search &search) {
+        const TAlphabet *seq = encoded[search.seq_id].data();
+        edge_index &result = edges[search.seq_id][search.i];
+        const size_t i = search.i;
+
+        if (search.edge) {
+            // continue the traversal from the previous (k+1)-mer
+            if (invalid[search.seq_id][i + k_]) {
+                result = npos;
+            } else {
+                result = pick_edge(fwd(search.edge, seq[i + k_ - 1]), seq[i + k_]);
+                if (result && i + 1 < search.end)
+                    W_->prefetch(result, seq[i + k_]);
+            }
+            search.edge = result;
+            return ++search.i < search.end;
+        }
+
+        if (!search.searching) {
+            // start a new search from scratch
+            if (invalid[search.seq_id][i + k_]) {
+                result = npos;
+                return ++search.i < search.end;
+            }
+
+            size_t offset;
+            std::tie(search.rl, search.ru, offset) = get_initial_range(seq + i, seq + i + k_);
+            if (search.rl > search.ru) {
+                result = npos;
+                return ++search.i < search.end;
+            }
+            search.searching = true;
+            search.pos = i + offset;
+
+        } else if (search.pos < i + k_) {
+            // match the next character
+            if (!tighten_range(&search.rl, &search.ru, seq[search.pos])) {
+                result = npos;
+                search.searching = false;
+                return ++search.i < search.end;
+            }
+            ++search.pos;
+        }
+
+        if (search.pos < i + k_) {
+            W_->prefetch(search.rl - 1, seq[search.pos]);
+            W_->prefetch(search.ru, seq[search.pos]);
+            return true;
+        }
+
+        // the k-mer is found, pick the outgoing edge
+        assert(succ_last(search.rl) <= search.ru);
+        result = pick_edge(search.ru, seq[i + k_]);
+        search.edge = result;
+        search.searching = false;
+        if (result && i + 1 < search.end)
+            W_->prefetch(result, seq[i + k_]);
+
+        return ++search.i < search.end;
+    };
+
+    // advance the active searches round-robin, replacing the finished ones
+    std::vector<Search*> active;
+    active.reserve(kNumInterleavedSearches);
+    auto next_search = searches.begin();
+    while (next_search != searches.end() && active.size() < kNumInterleavedSearches) {
+        active.push_back(&*next_search++);
+    }
+
+    while (active.size()) {
+        for (size_t j = 0; j < active.size(); ) {
+            if (step(*active[j])) {
+                ++j;
+            } else if (next_search != searches.end()) {
+                active[j++] = &*next_search++;
+            } else {
+                active[j] = active.back();
+                active.pop_back();
+            }
+        }
+    }
+
+    return edges;
+}
+
 /**
  * Returns the number of nodes in BOSS graph.
  */
@@ -1114,15 +1372,21 @@ std::string BOSS::decode(const std::vector<TAlphabet> &seq_encoded) const {
     return kmer_extractor_.decode(seq_encoded);
 }
 
+// W and last are independent, so they are converted concurrently
+// (each conversion may also use multiple threads internally)
 template <class WaveletTree, class BitVector>
 void convert(wavelet_tree **W_, bit_vector **last_) {
-    wavelet_tree *W_new = new WaveletTree((*W_)->convert_to<WaveletTree>());
-    delete *W_;
-    *W_ = W_new;
+    auto W_converted = std::async(std::launch::async, [W_]() {
+        wavelet_tree *W_new = new WaveletTree((*W_)->convert_to<WaveletTree>());
+        delete *W_;
+        *W_ = W_new;
+    });
 
     bit_vector *last_new = new BitVector((*last_)->convert_to<BitVector>());
     delete *last_;
     *last_ = last_new;
+
+    W_converted.wait();
 }
 
 void BOSS::switch_state(State new_state) {
@@ -1148,6 +1412,19 @@ void BOSS::switch_state(State new_state) {
             convert<wavelet_tree_dyn, bit_vector_dyn>(&W_, &last_);
             break;
         }
+        case State::INTERLEAVED: {
+            sdsl::int_vector<> W = W_->to_vector();
+            delete W_;
+            W_ = NULL;
+            sdsl::bit_vector last = last_->convert_to<sdsl::bit_vector>();
+            delete last_;
+            last_ = NULL;
+
+            auto table = std::make_shared<BOSSInterleavedTable>(bits_per_char_W_, W, last);
+            W_ = new wavelet_tree_interleaved(table);
+            last_ = new bit_vector_interleaved(table);
+            break;
+        }
     }
     state = new_state;
 }
@@ -1248,6 +1525,38 @@ void BOSS::add_sequence(std::string_view seq,
     }
 }
 
+void BOSS::add_sequences(std::vector<std::string>&& sequences,
+                         bool both_strands,
+                         std::vector<edge_index> *edges_inserted,
+                         size_t num_threads) {
+    if (edges_inserted)
+        edges_inserted->clear();
+
+    if (sequences.empty())
+        return;
+
+    BOSSConstructor constructor(k_, both_strands, 0, "", num_threads);
+    constructor.add_sequences(std::move(sequences));
+    BOSS batch(&constructor);
+
+    State old_state = state;
+
+    std::unique_ptr<BOSS> merged(boss::merge({ this, &batch }, false, edges_inserted));
+
+    std::swap(W_, merged->W_);
+    std::swap(last_, merged->last_);
+    F_ = merged->F_;
+    NF_ = merged->NF_;
+    state = merged->state;
+    merged.reset();
+
+    // the indexed node ranges have shifted
+    if (indexed_suffix_length_)
+        index_suffix_ranges(indexed_suffix_length_, num_threads);
+
+    switch_state(old_state);
+}
+
 /**
  * Given a character c and an edge index, this function
  * creates an outgoing edge from the same source node with
@@ -1403,61 +1712,129 @@ void BOSS::erase_edges_dyn(const std::set<edge_index> &edges) {
  * may invalidate the BOSS table (if leaves nodes with no incoming edges).
  * Returns the number of edges erased.
  */
-uint64_t BOSS::erase_edges(const sdsl::bit_vector &edges_to_remove_mask) {
+uint64_t BOSS::erase_edges(const sdsl::bit_vector &edges_to_remove_mask,
+                           size_t num_threads) {
+    assert(edges_to_remove_mask.size() == W_->size());
+
     uint64_t num_edges_to_remove = sdsl::util::cnt_one_bits(edges_to_remove_mask);
     if (!num_edges_to_remove)
         return 0;
 
-    // update last
-    sdsl::bit_vector old_last = last_->convert_to<sdsl::bit_vector>();
+    sdsl::bit_vector old_last;
+    sdsl::int_vector<> old_W;
+    {
+        auto W_extracted = std::async(std::launch::async,
+                                      [&]() { old_W = W_->to_vector(); });
+        old_last = last_->convert_to<sdsl::bit_vector>();
+        W_extracted.wait();
+    }
     delete last_;
-    sdsl::bit_vector last(old_last.size() - num_edges_to_remove, false);
-
-    for (edge_index i = 0, new_i = 0; i < edges_to_remove_mask.size(); ++i) {
-        if (!edges_to_remove_mask[i]) {
-            last[new_i++] = old_last[i];
-        } else {
-            if (old_last[i] && new_i > 1 && !last[new_i - 1])
-                last[new_i - 1] = 1;
+    last_ = NULL;
+    delete W_;
+    W_ = NULL;
+
+    // The edges are split into blocks processed in parallel. A kept edge with a
+    // minus-marked label gets unmarked if the edge with the same label preceding
+    // it in W was removed, so this state is propagated between the blocks.
+    enum FirstRemoved : uint8_t { UNCHANGED = 0, REMOVED, KEPT };
+
+    const uint64_t num_edges = edges_to_remove_mask.size();
+    num_threads = std::max(num_threads, size_t(1));
+    const uint64_t block_size = std::max(uint64_t(1) << 12, num_edges / (num_threads * 16));
+    const uint64_t num_blocks = (num_edges + block_size - 1) / block_size;
+
+    // the number of edges kept and the state at the end of each block
+    std::vector<uint64_t> block_offsets(num_blocks + 1, 0);
+    std::vector<std::vector<FirstRemoved>> block_states(num_blocks,
+                                                        std::vector<FirstRemoved>(alph_size));
+
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+    for (uint64_t b = 0; b < num_blocks; ++b) {
+        const uint64_t end = std::min(num_edges, (b + 1) * block_size);
+        for (edge_index i = b * block_size; i < end; ++i) {
+            TAlphabet c = old_W[i];
+            if (edges_to_remove_mask[i]) {
+                if (c < alph_size)
+                    block_states[b][c] = REMOVED;
+            } else {
+                block_states[b][c % alph_size] = KEPT;
+            }
         }
+        block_offsets[b + 1] = end - b * block_size
+                                - count_ones(edges_to_remove_mask, b * block_size, end);
     }
-    last_ = new bit_vector_stat(std::move(last));
 
-    // update W
-    sdsl::int_vector<> old_W = W_->to_vector();
-    delete W_;
-    sdsl::int_vector<> W(old_W.size() - num_edges_to_remove, 0, bits_per_char_W_);
+    // turn the block states into the states at the block starts
     std::vector<bool> first_removed(alph_size, false);
+    for (uint64_t b = 0; b < num_blocks; ++b) {
+        block_offsets[b + 1] += block_offsets[b];
+        for (TAlphabet c = 0; c < alph_size; ++c) {
+            FirstRemoved block_state = block_states[b][c];
+            block_states[b][c] = first_removed[c] ? REMOVED : KEPT;
+            if (block_state != UNCHANGED)
+                first_removed[c] = (block_state == REMOVED);
+        }
+    }
+    assert(block_offsets.back() == num_edges - num_edges_to_remove);
+
+    sdsl::bit_vector last(num_edges - num_edges_to_remove, false);
+    sdsl::int_vector<> W(num_edges - num_edges_to_remove, 0, bits_per_char_W_);
+    // the blocks of W share at most one word with their neighbours
+    std::mutex backup_mutex;
+
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+    for (uint64_t b = 0; b < num_blocks; ++b) {
+        std::vector<bool> first_removed(alph_size);
+        for (TAlphabet c = 0; c < alph_size; ++c) {
+            first_removed[c] = (block_states[b][c] == REMOVED);
+        }
+        const uint64_t end = std::min(num_edges, (b + 1) * block_size);
+        const uint64_t new_begin = block_offsets[b];
+        const uint64_t new_end = block_offsets[b + 1];
+
+        for (edge_index i = b * block_size, new_i = new_begin; i < end; ++i) {
+            // update last
+            if (!edges_to_remove_mask[i]) {
+                if (old_last[i])
+                    set_bit(last.data(), new_i, true, __ATOMIC_RELAXED);
+            } else if (old_last[i] && new_i > 1) {
+                // the bit may belong to the previous block
+                set_bit(last.data(), new_i - 1, true, __ATOMIC_RELAXED);
+            }
 
-    for (edge_index i = 0, new_i = 0; i < edges_to_remove_mask.size(); ++i) {
-        TAlphabet c = old_W[i];
-        if (edges_to_remove_mask[i]) {
-            if (c < alph_size)
-                first_removed[c] = true;
-        } else {
-            assert(c != alph_size);
-            if (c > alph_size && first_removed[c % alph_size]) {
-                W[new_i++] = c % alph_size;
+            // update W
+            TAlphabet c = old_W[i];
+            if (edges_to_remove_mask[i]) {
+                if (c < alph_size)
+                    first_removed[c] = true;
             } else {
-                W[new_i++] = c;
+                assert(c != alph_size);
+                if (c > alph_size && first_removed[c % alph_size])
+                    c %= alph_size;
+
+                if (new_i < new_begin + 64 || new_i + 64 >= new_end) {
+                    atomic_exchange(W, new_i, c, backup_mutex, __ATOMIC_RELAXED);
+                } else {
+                    W[new_i] = c;
+                }
+                new_i++;
+                first_removed[c % alph_size] = false;
             }
-            first_removed[c % alph_size] = false;
         }
     }
-    W_ = new wavelet_tree_stat(bits_per_char_W_, std::move(W));
+    old_W = sdsl::int_vector<>();
+
+    // construct the rank/select support for W and last concurrently
+    auto W_built = std::async(std::launch::async, [&]() {
+        W_ = new wavelet_tree_stat(bits_per_char_W_, std::move(W));
+    });
+    last_ = new bit_vector_stat(std::move(last));
+    W_built.wait();
 
     // update F
-    TAlphabet c = 0;
-    uint64_t count = 0;
-    for (edge_index i = 1; i <= F_.back(); ++i) {
-        while (i > F_[c] && c < alph_size) {
-            F_[c++] = count;
-        }
-        if (!edges_to_remove_mask[i])
-            count++;
-    }
-    while (c < alph_size) {
-        F_[c++] = count;
+    std::vector<edge_index> old_F = F_;
+    for (TAlphabet c = 0; c < alph_size; ++c) {
+        F_[c] = old_F[c] - count_ones(edges_to_remove_mask, 1, old_F[c] + 1);
     }
 
     recompute_NF();
@@ -1699,7 +2076,7 @@ BOSS::erase_redundant_dummy_edges(sdsl::bit_vector *source_dummy_edges,
                   << num_dummy_traversed << std::endl;
     }
 
-    auto num_edges_erased = erase_edges(redundant_dummy_edges_mask);
+    auto num_edges_erased = erase_edges(redundant_dummy_edges_mask, num_threads);
     if (source_dummy_edges)
         utils::erase(source_dummy_edges, redundant_dummy_edges_mask);
 
@@ -3147,11 +3524,14 @@ void BOSS::call_kmers(Call<edge_index, const std::string&> callback) const {
     }
 }
 
-void BOSS::index_suffix_ranges(size_t suffix_length) {
+void BOSS::index_suffix_ranges(size_t suffix_length, size_t num_threads) {
     assert(suffix_length <= k_);
 
     indexed_suffix_length_ = suffix_length;
     indexed_suffix_ranges_.clear();
+    sparse_suffixes_.reset();
+    sparse_suffix_begins_.reset();
+    sparse_suffix_ends_.reset();
 
     if (indexed_suffix_length_ == 0u)
         return;
@@ -3159,6 +3539,17 @@ void BOSS::index_suffix_ranges(size_t suffix_length) {
     if (indexed_suffix_length_ * log2(alph_size - 1) >= 64)
         throw std::runtime_error("ERROR: Trying to index too long suffixes");
 
+    uint64_t num_all_suffixes = 1;
+    for (size_t len = 1; len <= indexed_suffix_length_; ++len) {
+        num_all_suffixes *= (alph_size - 1);
+    }
+
+    // most of the ranges would be empty, hence, index only the non-empty ones
+    if (num_all_suffixes > W_->size()) {
+        index_sparse_suffix_ranges(num_all_suffixes, num_threads);
+        return;
+    }
+
     std::vector<std::tuple<uint64_t, edge_index, edge_index>> suffix_ranges;
 
     // first, take empty suffix and the entire range of nodes in the BOSS table
@@ -3219,6 +3610,103 @@ void BOSS::index_suffix_ranges(size_t suffix_length) {
                           utils::LessSecond()));
 }
 
+void BOSS::index_sparse_suffix_ranges(uint64_t num_all_suffixes, size_t num_threads) {
+    // the range of nodes with suffix |idx| of length |len|
+    struct SuffixRange {
+        uint64_t idx;
+        edge_index rl;
+        edge_index ru;
+        size_t len;
+    };
+
+    // Narrow down the ranges breadth-first until there are enough of them
+    // to be extended in parallel. Each range is then extended independently.
+    const size_t min_num_tasks = std::max(num_threads, size_t(1)) * 64;
+    std::vector<SuffixRange> tasks = { { 0, 1, W_->size() - 1, 0 } };
+    uint64_t num_suffixes = 1;
+
+    while (tasks.size() && tasks.size() < min_num_tasks
+            && tasks.front().len + 1 < indexed_suffix_length_) {
+        std::vector<SuffixRange> narrowed;
+        narrowed.reserve(tasks.size() * (alph_size - 1));
+
+        for (const auto &[idx, rl, ru, len] : tasks) {
+            // prepend the suffix with one of the |alph_size - 1| possible characters
+            for (TAlphabet c = 1; c < alph_size; ++c) {
+                edge_index rl_next = rl;
+                edge_index ru_next = ru;
+                if (tighten_range(&rl_next, &ru_next, c))
+                    narrowed.push_back({ num_suffixes * (c - 1) + idx, rl_next, ru_next, len + 1 });
+            }
+        }
+        tasks.swap(narrowed);
+        num_suffixes *= (alph_size - 1);
+    }
+
+    // non-empty ranges of suffixes of length |indexed_suffix_length_|
+    std::vector<std::vector<std::tuple<edge_index, edge_index, uint64_t>>> ranges(tasks.size());
+
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        // extend the suffixes depth-first
+        std::vector<std::pair<SuffixRange, uint64_t>> stack = { { tasks[t], num_suffixes } };
+        while (stack.size()) {
+            auto [range, shift] = stack.back();
+            stack.pop_back();
+
+            for (TAlphabet c = 1; c < alph_size; ++c) {
+                edge_index rl_next = range.rl;
+                edge_index ru_next = range.ru;
+                if (!tighten_range(&rl_next, &ru_next, c))
+                    continue;
+
+                uint64_t idx = shift * (c - 1) + range.idx;
+                if (range.len + 1 == indexed_suffix_length_) {
+                    ranges[t].emplace_back(rl_next, ru_next, idx);
+                } else {
+                    stack.push_back({ { idx, rl_next, ru_next, range.len + 1 },
+                                      shift * (alph_size - 1) });
+                }
+            }
+        }
+    }
+
+    std::vector<std::tuple<edge_index, edge_index, uint64_t>> all_ranges;
+    for (auto &task_ranges : ranges) {
+        all_ranges.insert(all_ranges.end(), task_ranges.begin(), task_ranges.end());
+        task_ranges = {};
+    }
+    // the node ranges are disjoint and follow the order of their suffixes
+    ips4o::parallel::sort(all_ranges.begin(), all_ranges.end(),
+                          std::less<std::tuple<edge_index, edge_index, uint64_t>>(),
+                          num_threads);
+
+    sparse_suffixes_ = std::make_unique<bit_vector_sd>(
+        [&](const auto &callback) {
+            for (const auto &[rl, ru, idx] : all_ranges) {
+                callback(idx);
+            }
+        },
+        num_all_suffixes, all_ranges.size()
+    );
+    sparse_suffix_begins_ = std::make_unique<bit_vector_sd>(
+        [&](const auto &callback) {
+            for (const auto &[rl, ru, idx] : all_ranges) {
+                callback(rl);
+            }
+        },
+        W_->size(), all_ranges.size()
+    );
+    sparse_suffix_ends_ = std::make_unique<bit_vector_sd>(
+        [&](const auto &callback) {
+            for (const auto &[rl, ru, idx] : all_ranges) {
+                callback(ru);
+            }
+        },
+        W_->size(), all_ranges.size()
+    );
+}
+
 bool BOSS::is_valid() const {
     assert((*W_)[0] == 0);
     assert(W_->size() >= 2);
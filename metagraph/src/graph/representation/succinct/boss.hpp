@@ -100,6 +100,26 @@ class BOSS {
     std::vector<edge_index>
     map_to_edges(const std::vector<TAlphabet> &seq_encoded) const;
 
+    // Map the (k+1)-mers of each of |sequences| to the graph edges and return
+    // the same edges as map_to_edges for each sequence. The searches for
+    // different sequences (and for segments of long sequences) are advanced in
+    // lock-step, so that their rank and select queries overlap in memory.
+    std::vector<std::vector<edge_index>>
+    map_to_edges_batch(const std::vector<std::string_view> &sequences) const;
+
+    // Map the (k+1)-mers of |seq_encoded| and their reverse complements to the
+    // graph edges in a single pass and call callback(edge, rc_edge) for each.
+    // |complement| maps each character code to the code of its complement.
+    // The graph must contain the reverse complement of each of its (k+1)-mers.
+    // The reverse complement edges are reached with bwd from the previous ones
+    // while their source nodes have a single incoming edge, and are searched
+    // from scratch only at restarts.
+    // |seq_encoded| must have no sentinels (zeros)
+    void map_to_edges_with_rc(const std::vector<TAlphabet> &seq_encoded,
+                              const std::vector<TAlphabet> &complement,
+                              const std::function<void(edge_index, edge_index)> &callback,
+                              const std::function<bool()> &terminate = ALWAYS_FALSE) const;
+
     template <class... T>
     using Call = typename std::function<void(T...)>;
 
@@ -191,6 +211,22 @@ class BOSS {
                       bool try_extend = false,
                       std::vector<edge_index> *edges_inserted = NULL);
 
+    /**
+     * Add a batch of sequences to the graph. The (k+1)-mers of the sequences
+     * are sorted into a new BOSS table, which is then merged with this one
+     * in a single linear pass. In contrast to add_sequence, works in any state
+     * and does not require the dynamic representation. The state is preserved.
+     * If passed, |edges_inserted| is replaced with the indexes of the new edges
+     * in the updated graph, in increasing order.
+     * Every call rewrites the whole BOSS table, keeping two copies of it in
+     * memory during the merge, and rebuilds the index of node ranges if there
+     * is one. Hence, the sequences should be added in as few batches as possible.
+     */
+    void add_sequences(std::vector<std::string>&& sequences,
+                       bool both_strands = false,
+                       std::vector<edge_index> *edges_inserted = NULL,
+                       size_t num_threads = 1);
+
     // Given an edge list, remove them from the graph.
     // TODO: fix the implementation (anchoring the isolated nodes)
     void erase_edges_dyn(const std::set<edge_index> &edges);
@@ -282,8 +318,11 @@ class BOSS {
      * Suffixes with sentinel characters are not indexed.
      * After the index is constructed, it speeds up search in the BOSS table
      * by narrowing down the initial node range and skipping several fwd calls.
+     * If there are more possible suffixes than edges in the graph, only the
+     * non-empty ranges are indexed, in compressed form, which allows indexing
+     * much longer suffixes.
      */
-    void index_suffix_ranges(size_t suffix_length);
+    void index_suffix_ranges(size_t suffix_length, size_t num_threads = 1);
 
     size_t get_indexed_suffix_length() const { return indexed_suffix_length_; }
 
@@ -319,8 +358,13 @@ class BOSS {
      *      Representation:
      *          last -- bit_vector_dyn
      *             W -- wavelet_tree_dyn
+     *
+     * INTERLEAVED: stores W and last together in cache line blocks,
+     *              for traversals with few cache misses
+     *      Representation:
+     *          last, W -- BOSSInterleavedTable
      */
-    enum State { SMALL = 1, DYN, STAT, FAST };
+    enum State { SMALL = 1, DYN, STAT, FAST, INTERLEAVED };
 
     State get_state() const { return state; }
     void switch_state(State state);
@@ -516,6 +560,13 @@ class BOSS {
 
     size_t indexed_suffix_length_ = 0;
     std::vector<std::pair<edge_index, edge_index>> indexed_suffix_ranges_;
+    // sparse index of node ranges: indexes of the non-empty suffixes
+    // and the first and last edges of their ranges
+    std::unique_ptr<bit_vector> sparse_suffixes_;
+    std::unique_ptr<bit_vector> sparse_suffix_begins_;
+    std::unique_ptr<bit_vector> sparse_suffix_ends_;
+
+    void index_sparse_suffix_ranges(uint64_t num_suffixes, size_t num_threads);
 
     /**
      * This function gets a character c and updates the edge offsets F_
@@ -548,7 +599,8 @@ class BOSS {
      * may invalidate the graph (if leaves nodes with no incoming edges).
      * Returns the number of edges erased.
      */
-    uint64_t erase_edges(const sdsl::bit_vector &edges_to_remove_mask);
+    uint64_t erase_edges(const sdsl::bit_vector &edges_to_remove_mask,
+                         size_t num_threads = 1);
 
     /**
      * This function gets two edge indices and returns if their source
@@ -639,7 +691,18 @@ BOSS::get_initial_range(RandomAccessIt begin, RandomAccessIt end) const {
         }
 
         // query range
-        std::tie(rl, ru) = indexed_suffix_ranges_[index];
+        if (sparse_suffixes_) {
+            if (uint64_t rank = sparse_suffixes_->conditional_rank1(index)) {
+                rl = sparse_suffix_begins_->select1(rank);
+                ru = sparse_suffix_ends_->select1(rank);
+            } else {
+                // empty range
+                rl = 1;
+                ru = 0;
+            }
+        } else {
+            std::tie(rl, ru) = indexed_suffix_ranges_[index];
+        }
         offset = indexed_suffix_length_;
 
     } else {
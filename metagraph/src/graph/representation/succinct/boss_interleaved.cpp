@@ -0,0 +1,349 @@
+#include "boss_interleaved.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "common/serialization.hpp"
+
+
+namespace mtg {
+namespace graph {
+namespace boss {
+
+BOSSInterleavedTable::BOSSInterleavedTable(uint8_t logsigma,
+                                           const sdsl::int_vector<> &W,
+                                           const sdsl::bit_vector &last)
+      : size_(W.size()), logsigma_(logsigma) {
+    assert(W.size() == last.size());
+    assert(logsigma_ && logsigma_ < 64);
+
+    num_symbols_ = W.size() ? *std::max_element(W.begin(), W.end()) + 1 : 1;
+    assert(num_symbols_ <= (1llu << logsigma_));
+
+    const uint64_t num_counters = num_symbols_ + 1;
+    // round up to a whole number of cache lines
+    words_per_block_ = (logsigma_ + 1 + (num_counters + 3) / 4 + 7) / 8 * 8;
+
+    const uint64_t num_blocks = (size_ + kBlockSize - 1) / kBlockSize;
+    data_.assign(num_blocks * words_per_block_ / 8, CacheLine {});
+    superblock_ranks_.assign(
+        (num_blocks + kBlocksPerSuperblock - 1) / kBlocksPerSuperblock * num_counters, 0
+    );
+    counts_.assign(num_counters, 0);
+
+    for (uint64_t b = 0; b < num_blocks; ++b) {
+        uint64_t *words = block(b);
+        const uint64_t *superblock_ranks
+            = superblock_ranks_.data() + b / kBlocksPerSuperblock * num_counters;
+
+        if (b % kBlocksPerSuperblock == 0)
+            std::copy(counts_.begin(), counts_.end(), superblock_ranks_.begin()
+                                                        + b / kBlocksPerSuperblock * num_counters);
+
+        char *block_ranks = reinterpret_cast<char*>(words + logsigma_ + 1);
+        for (uint64_t id = 0; id < num_counters; ++id) {
+            uint16_t rank = counts_[id] - superblock_ranks[id];
+            std::memcpy(block_ranks + id * sizeof(rank), &rank, sizeof(rank));
+        }
+
+        for (uint64_t j = 0, i = b * kBlockSize; j < kBlockSize && i < size_; ++j, ++i) {
+            TAlphabet c = W[i];
+            for (uint8_t p = 0; p < logsigma_; ++p) {
+                words[p] |= ((c >> p) & 1) << j;
+            }
+            counts_[c]++;
+
+            if (last[i]) {
+                words[logsigma_] |= 1llu << j;
+                counts_[num_symbols_]++;
+            }
+        }
+    }
+
+    init_select_samples();
+}
+
+uint64_t BOSSInterleavedTable::match(uint64_t b, uint64_t id) const {
+    const uint64_t *words = block(b);
+
+    uint64_t mask;
+    if (id == num_symbols_) {
+        mask = words[logsigma_];
+    } else {
+        mask = ~0llu;
+        for (uint8_t p = 0; p < logsigma_; ++p) {
+            mask &= ((id >> p) & 1) ? words[p] : ~words[p];
+        }
+    }
+
+    // skip the padding in the last block
+    if ((b + 1) * kBlockSize > size_)
+        mask &= ~0llu >> ((b + 1) * kBlockSize - size_);
+
+    return mask;
+}
+
+uint64_t BOSSInterleavedTable::block_rank(uint64_t b, uint64_t id) const {
+    uint16_t rank;
+    std::memcpy(&rank, reinterpret_cast<const char*>(block(b) + logsigma_ + 1)
+                            + id * sizeof(rank), sizeof(rank));
+    return superblock_ranks_[b / kBlocksPerSuperblock * (num_symbols_ + 1) + id] + rank;
+}
+
+uint64_t BOSSInterleavedTable::rank(uint64_t id, uint64_t i) const {
+    assert(i < size_);
+    uint64_t b = i / kBlockSize;
+    return block_rank(b, id)
+            + sdsl::bits::cnt(match(b, id) & (~0llu >> (kBlockSize - 1 - i % kBlockSize)));
+}
+
+uint64_t BOSSInterleavedTable::select(uint64_t id, uint64_t r) const {
+    assert(r && r <= counts_[id]);
+
+    // the blocks with the sampled occurrences bound the search
+    const auto &samples = select_samples_[id];
+    uint64_t s = (r - 1) / kSelectSampleRate;
+    uint64_t lo = samples[s];
+    uint64_t hi = s + 1 < samples.size()
+                    ? samples[s + 1]
+                    : (size_ - 1) / kBlockSize;
+
+    // find the last block with less than |r| occurrences before it
+    while (lo < hi) {
+        uint64_t mid = (lo + hi + 1) / 2;
+        if (block_rank(mid, id) < r) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    return lo * kBlockSize + sdsl::bits::sel(match(lo, id), r - block_rank(lo, id));
+}
+
+void BOSSInterleavedTable::init_select_samples() {
+    const uint64_t num_counters = num_symbols_ + 1;
+    const uint64_t num_blocks = (size_ + kBlockSize - 1) / kBlockSize;
+
+    select_samples_.assign(num_counters, {});
+    for (uint64_t id = 0; id < num_counters; ++id) {
+        select_samples_[id].reserve(counts_[id] / kSelectSampleRate + 1);
+    }
+
+    for (uint64_t b = 0; b < num_blocks; ++b) {
+        for (uint64_t id = 0; id < num_counters; ++id) {
+            auto &samples = select_samples_[id];
+            uint64_t rank_end = block_rank(b, id) + sdsl::bits::cnt(match(b, id));
+            // the next sampled occurrence is in this block
+            while (samples.size() * kSelectSampleRate < rank_end) {
+                samples.push_back(b);
+            }
+        }
+    }
+}
+
+BOSSInterleavedTable::TAlphabet BOSSInterleavedTable::get_W(uint64_t i) const {
+    assert(i < size_);
+    const uint64_t *words = block(i / kBlockSize);
+    const uint64_t j = i % kBlockSize;
+
+    TAlphabet c = 0;
+    for (uint8_t p = 0; p < logsigma_; ++p) {
+        c |= ((words[p] >> j) & 1) << p;
+    }
+    return c;
+}
+
+uint64_t BOSSInterleavedTable::rank_W(TAlphabet c, uint64_t i) const {
+    return c < num_symbols_ ? rank(c, i) : 0;
+}
+
+uint64_t BOSSInterleavedTable::select_W(TAlphabet c, uint64_t r) const {
+    assert(c < num_symbols_);
+    return select(c, r);
+}
+
+uint64_t BOSSInterleavedTable::rank_last(uint64_t i) const {
+    return rank(num_symbols_, i);
+}
+
+uint64_t BOSSInterleavedTable::select_last(uint64_t r) const {
+    return select(num_symbols_, r);
+}
+
+bool BOSSInterleavedTable::load(std::istream &in) {
+    if (!in.good())
+        return false;
+
+    try {
+        size_ = load_number(in);
+        logsigma_ = load_number(in);
+        num_symbols_ = load_number(in);
+        words_per_block_ = load_number(in);
+
+        if (!logsigma_ || logsigma_ >= 64 || num_symbols_ > (1llu << logsigma_)
+                || words_per_block_ % 8
+                || words_per_block_ < logsigma_ + 1 + (num_symbols_ + 4) / 4)
+            return false;
+
+        const uint64_t num_blocks = (size_ + kBlockSize - 1) / kBlockSize;
+        data_.resize(num_blocks * words_per_block_ / 8);
+        in.read(reinterpret_cast<char *>(data_.data()), data_.size() * sizeof(CacheLine));
+
+        superblock_ranks_ = load_number_vector_raw<uint64_t>(in);
+        counts_ = load_number_vector_raw<uint64_t>(in);
+
+        if (!in.good() || counts_.size() != num_symbols_ + 1)
+            return false;
+
+        init_select_samples();
+
+        return true;
+
+    } catch (const std::bad_alloc &exception) {
+        std::cerr << "ERROR: Not enough memory to load the interleaved BOSS table"
+                  << std::endl;
+        return false;
+    } catch (...) {
+        return false;
+    }
+}
+
+void BOSSInterleavedTable::serialize(std::ostream &out) const {
+    serialize_number(out, size_);
+    serialize_number(out, logsigma_);
+    serialize_number(out, num_symbols_);
+    serialize_number(out, words_per_block_);
+    out.write(reinterpret_cast<const char *>(data_.data()), data_.size() * sizeof(CacheLine));
+    serialize_number_vector_raw(out, superblock_ranks_);
+    serialize_number_vector_raw(out, counts_);
+}
+
+sdsl::int_vector<> BOSSInterleavedTable::W_to_vector() const {
+    sdsl::int_vector<> W(size_, 0, logsigma_);
+    for (uint64_t i = 0; i < size_; ++i) {
+        W[i] = get_W(i);
+    }
+    return W;
+}
+
+sdsl::bit_vector BOSSInterleavedTable::last_to_vector() const {
+    sdsl::bit_vector last(size_, false);
+    for (uint64_t i = 0; i < size_; i += kBlockSize) {
+        last.set_int(i, get_last_word(i / kBlockSize), std::min(kBlockSize, size_ - i));
+    }
+    return last;
+}
+
+
+std::pair<uint64_t, wavelet_tree::TAlphabet>
+wavelet_tree_interleaved::inverse_select(uint64_t i) const {
+    TAlphabet c = table_->get_W(i);
+    return std::make_pair(table_->rank_W(c, i), c);
+}
+
+uint64_t wavelet_tree_interleaved::next(uint64_t i, TAlphabet c) const {
+    assert(i < size());
+
+    // check the block of |i| first
+    if (uint64_t mask = table_->match_W(i / 64, c) & (~0llu << (i % 64)))
+        return i - i % 64 + __builtin_ctzll(mask);
+
+    uint64_t r = table_->rank_W(c, i);
+    return r < table_->count_W(c) ? table_->select_W(c, r + 1) : size();
+}
+
+uint64_t wavelet_tree_interleaved::prev(uint64_t i, TAlphabet c) const {
+    assert(i < size());
+
+    // check the block of |i| first
+    if (uint64_t mask = table_->match_W(i / 64, c) & (~0llu >> (63 - i % 64)))
+        return i - i % 64 + 63 - __builtin_clzll(mask);
+
+    uint64_t r = table_->rank_W(c, i);
+    return r ? table_->select_W(c, r) : size();
+}
+
+
+uint64_t bit_vector_interleaved::select0(uint64_t i) const {
+    assert(i > 0 && size() > 0 && i <= size() - num_set_bits());
+
+    // find the first position with |i| unset bits up to it
+    uint64_t lo = i - 1;
+    uint64_t hi = size() - 1;
+    while (lo < hi) {
+        uint64_t mid = (lo + hi) / 2;
+        if (rank0(mid) < i) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+uint64_t bit_vector_interleaved::next1(uint64_t id) const {
+    assert(id < size());
+
+    if (uint64_t word = table_->get_last_word(id / 64) & (~0llu << (id % 64)))
+        return id - id % 64 + __builtin_ctzll(word);
+
+    uint64_t r = rank1(id);
+    return r < num_set_bits() ? select1(r + 1) : size();
+}
+
+uint64_t bit_vector_interleaved::prev1(uint64_t id) const {
+    assert(id < size());
+
+    if (uint64_t word = table_->get_last_word(id / 64) & (~0llu >> (63 - id % 64)))
+        return id - id % 64 + 63 - __builtin_clzll(word);
+
+    uint64_t r = rank1(id);
+    return r ? select1(r) : size();
+}
+
+uint64_t bit_vector_interleaved::get_int(uint64_t id, uint32_t width) const {
+    assert(width && width <= 64);
+    assert(id + width <= size());
+
+    uint64_t offset = id % 64;
+    uint64_t word = table_->get_last_word(id / 64) >> offset;
+    if (offset + width > 64)
+        word |= table_->get_last_word(id / 64 + 1) << (64 - offset);
+
+    return width < 64 ? word & ((1llu << width) - 1) : word;
+}
+
+void bit_vector_interleaved::add_to(sdsl::bit_vector *other) const {
+    assert(other);
+    assert(other->size() == size());
+
+    uint64_t *data = other->data();
+    for (uint64_t b = 0; b * 64 < size(); ++b) {
+        data[b] |= table_->get_last_word(b);
+    }
+}
+
+void bit_vector_interleaved::call_ones_in_range(uint64_t begin, uint64_t end,
+                                                const VoidCall<uint64_t> &callback) const {
+    assert(begin <= end);
+    assert(end <= size());
+
+    for (uint64_t b = begin / 64; b * 64 < end; ++b) {
+        uint64_t word = table_->get_last_word(b);
+        if (b == begin / 64)
+            word &= ~0llu << (begin % 64);
+        if ((b + 1) * 64 > end)
+            word &= ~0llu >> ((b + 1) * 64 - end);
+
+        while (word) {
+            callback(b * 64 + __builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+}
+
+} // namespace boss
+} // namespace graph
+} // namespace mtg
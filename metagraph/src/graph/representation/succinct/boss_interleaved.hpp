@@ -0,0 +1,208 @@
+#ifndef __BOSS_INTERLEAVED_HPP__
+#define __BOSS_INTERLEAVED_HPP__
+
+#include <cassert>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <sdsl/int_vector.hpp>
+
+#include "common/vectors/bit_vector.hpp"
+#include "common/vectors/wavelet_tree.hpp"
+
+
+namespace mtg {
+namespace graph {
+namespace boss {
+
+/**
+ * The arrays W and last of the BOSS table stored together, in the manner of the
+ * occurrence tables of FM-indexes (e.g., in BWA).
+ *
+ * The arrays are split into blocks of 64 edges aligned to cache lines. Each
+ * block stores the bit planes of the W labels, the last bits, and the ranks of
+ * every label and of the last bits at the block start (relative to a superblock).
+ * Thus, the rank queries on W and last for nearby edges, as well as accessing
+ * their values, touch a single block. For the DNA alphabet, a block takes
+ * exactly one cache line (64 bytes).
+ */
+class BOSSInterleavedTable {
+  public:
+    typedef uint64_t TAlphabet;
+
+    BOSSInterleavedTable() {}
+    BOSSInterleavedTable(uint8_t logsigma,
+                         const sdsl::int_vector<> &W,
+                         const sdsl::bit_vector &last);
+
+    uint64_t size() const { return size_; }
+    uint8_t logsigma() const { return logsigma_; }
+
+    TAlphabet get_W(uint64_t i) const;
+    // the number of occurrences of |c| in W[0..i]
+    uint64_t rank_W(TAlphabet c, uint64_t i) const;
+    // the position of the |r|-th occurrence of |c| in W, starting from 1
+    uint64_t select_W(TAlphabet c, uint64_t r) const;
+    uint64_t count_W(TAlphabet c) const { return c < num_symbols_ ? counts_[c] : 0; }
+
+    bool get_last(uint64_t i) const {
+        assert(i < size_);
+        return (block(i >> 6)[logsigma_] >> (i & 63)) & 1;
+    }
+    // the number of set bits in last[0..i]
+    uint64_t rank_last(uint64_t i) const;
+    // the position of the |r|-th set bit in last, starting from 1
+    uint64_t select_last(uint64_t r) const;
+    uint64_t num_last() const { return size_ ? counts_[num_symbols_] : 0; }
+    // the word with bits last[64 * b, ..., 64 * b + 63]
+    uint64_t get_last_word(uint64_t b) const { return block(b)[logsigma_]; }
+
+    // the bits marking the positions with label |c| in the block |b|
+    uint64_t match_W(uint64_t b, TAlphabet c) const {
+        return c < num_symbols_ ? match(b, c) : 0;
+    }
+
+    void prefetch(uint64_t i) const {
+        if (i < size_)
+            __builtin_prefetch(block(i >> 6));
+    }
+
+    bool load(std::istream &in);
+    void serialize(std::ostream &out) const;
+
+    sdsl::int_vector<> W_to_vector() const;
+    sdsl::bit_vector last_to_vector() const;
+
+  private:
+    static constexpr uint64_t kBlockSize = 64;
+    // the block ranks are stored as 16-bit integers relative to the superblock
+    static constexpr uint64_t kBlocksPerSuperblock = 1024;
+    // sample the blocks of every k-th occurrence for select queries
+    static constexpr uint64_t kSelectSampleRate = 256;
+
+    struct alignas(64) CacheLine { uint64_t words[8]; };
+
+    template <typename T>
+    struct CacheLineAllocator {
+        typedef T value_type;
+        CacheLineAllocator() = default;
+        template <typename U>
+        CacheLineAllocator(const CacheLineAllocator<U>&) {}
+        T* allocate(size_t n) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(64)));
+        }
+        void deallocate(T *p, size_t) { ::operator delete(p, std::align_val_t(64)); }
+        bool operator==(const CacheLineAllocator&) const { return true; }
+        bool operator!=(const CacheLineAllocator&) const { return false; }
+    };
+
+    const uint64_t* block(uint64_t b) const {
+        return reinterpret_cast<const uint64_t*>(data_.data()) + b * words_per_block_;
+    }
+    uint64_t* block(uint64_t b) {
+        return reinterpret_cast<uint64_t*>(data_.data()) + b * words_per_block_;
+    }
+    // Counters |id| < |num_symbols_| are for the labels in W,
+    // and |id| = |num_symbols_| is for the set bits in last.
+    // The bits marking the positions matching counter |id| in the block |b|
+    uint64_t match(uint64_t b, uint64_t id) const;
+    // the rank of counter |id| before the block |b|
+    uint64_t block_rank(uint64_t b, uint64_t id) const;
+    uint64_t rank(uint64_t id, uint64_t i) const;
+    uint64_t select(uint64_t id, uint64_t r) const;
+
+    void init_select_samples();
+
+    uint64_t size_ = 0;
+    uint8_t logsigma_ = 0;
+    // labels in W are in [0, num_symbols_)
+    uint64_t num_symbols_ = 0;
+    uint64_t words_per_block_ = 0;
+    // per block: |logsigma_| bit planes of W, one plane of last,
+    // then |num_symbols_ + 1| 16-bit ranks relative to the superblock
+    std::vector<CacheLine, CacheLineAllocator<CacheLine>> data_;
+    // absolute ranks at the superblock starts
+    std::vector<uint64_t> superblock_ranks_;
+    std::vector<uint64_t> counts_;
+    std::vector<std::vector<uint64_t>> select_samples_;
+};
+
+
+// The W array of a BOSSInterleavedTable, shared with a bit_vector_interleaved
+class wavelet_tree_interleaved : public wavelet_tree {
+  public:
+    explicit wavelet_tree_interleaved(std::shared_ptr<BOSSInterleavedTable> table)
+      : table_(table) { assert(table_); }
+
+    uint64_t rank(TAlphabet c, uint64_t i) const { return table_->rank_W(c, i); }
+    uint64_t select(TAlphabet c, uint64_t i) const { return table_->select_W(c, i); }
+    TAlphabet operator[](uint64_t i) const { return table_->get_W(i); }
+    std::pair<uint64_t, TAlphabet> inverse_select(uint64_t i) const;
+
+    uint64_t next(uint64_t i, TAlphabet c) const;
+    uint64_t prev(uint64_t i, TAlphabet c) const;
+
+    uint64_t size() const { return table_->size(); }
+    uint8_t logsigma() const { return table_->logsigma(); }
+    uint64_t count(TAlphabet c) const { return table_->count_W(c); }
+
+    void prefetch(uint64_t i, TAlphabet) const { table_->prefetch(i); }
+
+    // loads and serializes the entire table, including the last array
+    bool load(std::istream &in) { return table_->load(in); }
+    void serialize(std::ostream &out) const { table_->serialize(out); }
+
+    void clear() { table_ = std::make_shared<BOSSInterleavedTable>(); }
+
+    sdsl::int_vector<> to_vector() const { return table_->W_to_vector(); }
+
+  private:
+    std::shared_ptr<BOSSInterleavedTable> table_;
+};
+
+
+// The last array of a BOSSInterleavedTable. It is loaded and
+// serialized with the W array, so load and serialize are no-ops.
+class bit_vector_interleaved : public bit_vector {
+  public:
+    explicit bit_vector_interleaved(std::shared_ptr<const BOSSInterleavedTable> table)
+      : table_(table) { assert(table_); }
+
+    uint64_t rank1(uint64_t id) const override { return table_->rank_last(id); }
+    uint64_t select1(uint64_t i) const override { return table_->select_last(i); }
+    uint64_t select0(uint64_t i) const override;
+
+    uint64_t next1(uint64_t id) const override;
+    uint64_t prev1(uint64_t id) const override;
+
+    void prefetch(uint64_t id) const override { table_->prefetch(id); }
+
+    bool operator[](uint64_t id) const override { return table_->get_last(id); }
+    uint64_t get_int(uint64_t id, uint32_t width) const override;
+
+    bool load(std::istream &in) override { return in.good(); }
+    void serialize(std::ostream &) const override {}
+
+    uint64_t size() const override { return table_->size(); }
+    uint64_t num_set_bits() const override { return table_->num_last(); }
+
+    void add_to(sdsl::bit_vector *other) const override;
+    void call_ones_in_range(uint64_t begin, uint64_t end,
+                            const VoidCall<uint64_t> &callback) const override;
+
+    std::unique_ptr<bit_vector> copy() const override {
+        return std::make_unique<bit_vector_interleaved>(*this);
+    }
+
+    sdsl::bit_vector to_vector() const override { return table_->last_to_vector(); }
+
+  private:
+    std::shared_ptr<const BOSSInterleavedTable> table_;
+};
+
+} // namespace boss
+} // namespace graph
+} // namespace mtg
+
+#endif // __BOSS_INTERLEAVED_HPP__
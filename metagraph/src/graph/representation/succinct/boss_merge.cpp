@@ -1,5 +1,6 @@
 #include "boss_merge.hpp"
 
+#include <algorithm>
 #include <thread>
 #include <mutex>
 
@@ -122,18 +123,25 @@ void print_bin_stats(const std::vector<std::vector<uint64_t>> &bins) {
 }
 
 
+// If passed, |from_first| marks the edges of the merged chunk present in Gv[0]
 BOSS::Chunk merge_blocks(const std::vector<const BOSS*> &Gv,
                          std::vector<uint64_t> kv,
                          const std::vector<uint64_t> &nv,
-                         bool verbose);
+                         bool verbose,
+                         std::vector<bool> *from_first = NULL);
 
 
-BOSS::Chunk merge_blocks_to_chunk(const std::vector<const BOSS*> &graphs,
-                                  size_t chunk_idx,
-                                  size_t num_chunks,
-                                  size_t num_threads,
-                                  size_t num_bins_per_thread,
-                                  bool verbose) {
+/**
+ * Split the BOSS tables into blocks and return the boundaries of the blocks
+ * of the |chunk_idx|-th chunk in each table.
+ */
+std::vector<std::vector<uint64_t>>
+get_merge_blocks(const std::vector<const BOSS*> &graphs,
+                 size_t chunk_idx,
+                 size_t num_chunks,
+                 size_t num_threads,
+                 size_t num_bins_per_thread,
+                 bool verbose) {
     assert(graphs.size() > 0);
     assert(num_chunks > 0);
     assert(chunk_idx < num_chunks);
@@ -179,30 +187,83 @@ BOSS::Chunk merge_blocks_to_chunk(const std::vector<const BOSS*> &graphs,
     if (verbose)
         print_bin_stats(bins);
 
+    return bins;
+}
+
+// Merge the |block_idx|-th block of the BOSS tables
+BOSS::Chunk merge_block(const std::vector<const BOSS*> &graphs,
+                        const std::vector<std::vector<uint64_t>> &bins,
+                        size_t block_idx,
+                        bool verbose) {
+    std::vector<uint64_t> kv;
+    std::vector<uint64_t> nv;
+    for (size_t i = 0; i < graphs.size(); i++) {
+        kv.push_back(bins.at(i).at(block_idx));
+        nv.push_back(bins.at(i).at(block_idx + 1));
+    }
+    return merge_blocks(graphs, kv, nv, verbose);
+}
+
+
+std::vector<std::string>
+merge_blocks_to_chunk_files(const std::vector<const BOSS*> &graphs,
+                            size_t chunk_idx,
+                            size_t num_chunks,
+                            size_t num_threads,
+                            size_t num_bins_per_thread,
+                            const std::string &outbase,
+                            bool verbose) {
+    auto bins = get_merge_blocks(graphs, chunk_idx, num_chunks,
+                                 num_threads, num_bins_per_thread, verbose);
+
     size_t num_blocks = bins.front().size() - 1;
 
-    BOSS::Chunk result(graphs.at(0)->alph_size, graphs.at(0)->get_k());
+    std::vector<std::string> chunk_files(num_blocks);
 
-    #pragma omp parallel for num_threads(num_threads) ordered
+    // The blocks are independent, so they are merged in any order
+    // and written to their own files
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
     for (size_t curr_idx = 0; curr_idx < num_blocks; ++curr_idx) {
-        std::vector<uint64_t> kv;
-        std::vector<uint64_t> nv;
-        for (size_t i = 0; i < graphs.size(); i++) {
-            kv.push_back(bins.at(i).at(curr_idx));
-            nv.push_back(bins.at(i).at(curr_idx + 1));
-        }
-        BOSS::Chunk chunk = merge_blocks(graphs, kv, nv, verbose);
-        #pragma omp ordered
-        {
-            result.extend(chunk);
-        }
+        chunk_files[curr_idx] = outbase + "." + std::to_string(curr_idx);
+        merge_block(graphs, bins, curr_idx, verbose).serialize(chunk_files[curr_idx]);
+    }
+
+    return chunk_files;
+}
+
+
+BOSS::Chunk merge_blocks_to_chunk(const std::vector<const BOSS*> &graphs,
+                                  size_t chunk_idx,
+                                  size_t num_chunks,
+                                  size_t num_threads,
+                                  size_t num_bins_per_thread,
+                                  bool verbose) {
+    auto bins = get_merge_blocks(graphs, chunk_idx, num_chunks,
+                                 num_threads, num_bins_per_thread, verbose);
+
+    size_t num_blocks = bins.front().size() - 1;
+
+    // The blocks are merged in any order and concatenated afterwards
+    std::vector<BOSS::Chunk> blocks(num_blocks);
+
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+    for (size_t curr_idx = 0; curr_idx < num_blocks; ++curr_idx) {
+        blocks[curr_idx] = merge_block(graphs, bins, curr_idx, verbose);
+    }
+
+    BOSS::Chunk result(graphs.at(0)->alph_size, graphs.at(0)->get_k());
+
+    for (auto &block : blocks) {
+        result.extend(block);
     }
 
     return result;
 }
 
 
-BOSS* merge(const std::vector<const BOSS*> &Gv, bool verbose) {
+BOSS* merge(const std::vector<const BOSS*> &Gv,
+            bool verbose,
+            std::vector<uint64_t> *edges_not_in_first) {
     std::vector<uint64_t> kv;
     std::vector<uint64_t> nv;
 
@@ -211,7 +272,18 @@ BOSS* merge(const std::vector<const BOSS*> &Gv, bool verbose) {
         nv.push_back(Gv[i]->get_W().size());
     }
 
-    BOSS::Chunk merged = merge_blocks(Gv, kv, nv, verbose);
+    std::vector<bool> from_first;
+    BOSS::Chunk merged = merge_blocks(Gv, kv, nv, verbose,
+                                      edges_not_in_first ? &from_first : NULL);
+
+    if (edges_not_in_first) {
+        assert(from_first.size() == merged.size());
+        edges_not_in_first->clear();
+        for (uint64_t i = 0; i < from_first.size(); ++i) {
+            if (!from_first[i])
+                edges_not_in_first->push_back(i);
+        }
+    }
 
     BOSS *graph = new BOSS(Gv.at(0)->get_k());
     merged.initialize_boss(graph);
@@ -253,12 +325,16 @@ std::vector<std::vector<TAlphabet>> get_last_added_nodes(const std::vector<const
 BOSS::Chunk merge_blocks(const std::vector<const BOSS*> &Gv,
                          std::vector<uint64_t> kv,
                          const std::vector<uint64_t> &nv,
-                         bool verbose) {
+                         bool verbose,
+                         std::vector<bool> *from_first) {
     assert(kv.size() == Gv.size());
     assert(nv.size() == Gv.size());
 
     BOSS::Chunk chunk(Gv.at(0)->alph_size, Gv.at(0)->get_k());
 
+    if (from_first)
+        from_first->assign(chunk.size(), true);
+
     const size_t alph_size = Gv.at(0)->alph_size;
 
     auto last_added_nodes = get_last_added_nodes(Gv, kv);
@@ -287,7 +363,7 @@ BOSS::Chunk merge_blocks(const std::vector<const BOSS*> &Gv,
         if (kv[i] < nv[i]) {
             auto seq = Gv[i]->get_node_seq(kv[i]);
             seq.insert(seq.begin(), Gv[i]->get_W(kv[i]) % alph_size);
-            min_kmers[seq].push_back(i);
+            min_kmers[std::move(seq)].push_back(i);
         }
     }
 
@@ -343,15 +419,34 @@ BOSS::Chunk merge_blocks(const std::vector<const BOSS*> &Gv,
         if (!remove_dummy_edge)
             chunk.push_back(next_in_W, seq1.back(), true);
 
+        if (from_first) {
+            bool in_first = std::find(emptying_blocks.begin(), emptying_blocks.end(), 0)
+                                != emptying_blocks.end();
+            if (!remove_dummy_edge) {
+                from_first->push_back(in_first);
+            } else if (in_first) {
+                from_first->back() = true;
+            }
+        }
+
         last_added_nodes[val] = seq1;
         ++added;
 
         for (size_t i : emptying_blocks) {
             kv[i]++;
             if (kv[i] < nv[i]) {
-                auto seq = Gv[i]->get_node_seq(kv[i]);
-                seq.insert(seq.begin(), Gv[i]->get_W(kv[i]) % alph_size);
-                min_kmers[seq].push_back(i);
+                std::vector<TAlphabet> seq;
+                if (Gv[i]->get_last(kv[i] - 1)) {
+                    seq = Gv[i]->get_node_seq(kv[i]);
+                    seq.insert(seq.begin(), 0);
+                } else {
+                    // the next edge of the same node, the node label is |seq1|
+                    seq.reserve(seq1.size() + 1);
+                    seq.push_back(0);
+                    seq.insert(seq.end(), seq1.begin(), seq1.end());
+                }
+                seq.front() = Gv[i]->get_W(kv[i]) % alph_size;
+                min_kmers[std::move(seq)].push_back(i);
             }
         }
     }
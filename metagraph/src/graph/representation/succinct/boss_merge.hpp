@@ -16,10 +16,37 @@ namespace boss {
     /**
      * Given a list of boss tables, this function
      * merges all of them into a new one.
+     * If passed, |edges_not_in_first| is filled with the indexes of the edges
+     * of the merged table which are not present in the first table, in
+     * increasing order. A dummy sink edge replaced by a regular edge keeps
+     * its index and is not reported.
      */
     BOSS* merge(const std::vector<const BOSS*> &graphs,
-                bool verbose = false);
+                bool verbose = false,
+                std::vector<uint64_t> *edges_not_in_first = NULL);
 
+    /**
+     * Split the BOSS tables into |num_threads * num_bins_per_thread * num_chunks|
+     * blocks and merge the blocks of the |chunk_idx|-th chunk in parallel.
+     * Each merged block is streamed to disk and written to a separate chunk
+     * file '<outbase>.<block>.dbg.chunk', so that the memory used per thread
+     * does not depend on the size of the graphs.
+     * Returns the list of the chunk files, in the order of the blocks, which
+     * can be passed to BOSS::Chunk::build_boss_from_chunks.
+     */
+    std::vector<std::string>
+    merge_blocks_to_chunk_files(const std::vector<const BOSS*> &graphs,
+                                size_t chunk_idx,
+                                size_t num_chunks,
+                                size_t num_threads,
+                                size_t num_bins_per_thread,
+                                const std::string &outbase,
+                                bool verbose = false);
+
+    /**
+     * Same as merge_blocks_to_chunk_files, but the merged blocks are kept in
+     * memory and concatenated into a single chunk.
+     */
     BOSS::Chunk merge_blocks_to_chunk(const std::vector<const BOSS*> &graphs,
                                       size_t chunk_idx,
                                       size_t num_chunks,
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <string>
 #include <filesystem>
+#include <numeric>
 
 #include "common/seq_tools/reverse_complement.hpp"
 #include "common/serialization.hpp"
@@ -231,6 +232,83 @@ void DBGSuccinct::add_sequence(std::string_view sequence,
         bloom_filter_->add_sequence(sequence);
 }
 
+void DBGSuccinct::add_sequences(std::vector<std::string>&& sequences,
+                                const std::function<void(node_index)> &on_insertion,
+                                size_t num_threads) {
+    if (bloom_filter_) {
+        for (const auto &sequence : sequences) {
+            bloom_filter_->add_sequence(sequence);
+        }
+    }
+
+    std::vector<uint64_t> boss_edges_inserted;
+    boss_graph_->add_sequences(std::move(sequences), mode_ == CANONICAL,
+                               &boss_edges_inserted, num_threads);
+
+    if (valid_edges_) {
+        // update bitmask with valid k-mers -- the inserted dummy edges stay
+        // masked out, since a masked graph must not expose dummy k-mers
+        auto is_real_kmer = [&](uint64_t i) {
+            return i > 1 && boss_graph_->get_W(i) % boss_graph_->alph_size
+                    && boss_graph_->get_node_seq(i)[0] != BOSS::kSentinelCode;
+        };
+        sdsl::bit_vector old_valid_edges = valid_edges_->to_vector();
+        sdsl::bit_vector valid_edges(boss_graph_->num_edges() + 1, false);
+        // the new nodes also include the masked out dummy sink edges
+        // replaced with regular edges in the merge
+        std::vector<uint64_t> new_valid_edges;
+        new_valid_edges.reserve(boss_edges_inserted.size());
+        uint64_t old_i = 0;
+        auto it = boss_edges_inserted.begin();
+        for (uint64_t i = 0; i < valid_edges.size(); ++i) {
+            if (it != boss_edges_inserted.end() && *it == i) {
+                ++it;
+                if (is_real_kmer(i)) {
+                    valid_edges[i] = true;
+                    new_valid_edges.push_back(i);
+                }
+            } else if (old_valid_edges[old_i++]) {
+                valid_edges[i] = true;
+            } else if (is_real_kmer(i)) {
+                valid_edges[i] = true;
+                new_valid_edges.push_back(i);
+            }
+        }
+        assert(old_i == old_valid_edges.size());
+        boss_edges_inserted.swap(new_valid_edges);
+
+        switch (get_state()) {
+            case BOSS::State::STAT: {
+                valid_edges_ = std::make_unique<bit_vector_small>(std::move(valid_edges));
+                break;
+            }
+            case BOSS::State::FAST: {
+                valid_edges_ = std::make_unique<bit_vector_stat>(std::move(valid_edges));
+                break;
+            }
+            case BOSS::State::DYN: {
+                valid_edges_ = std::make_unique<bit_vector_dyn>(std::move(valid_edges));
+                break;
+            }
+            case BOSS::State::SMALL: {
+                valid_edges_ = std::make_unique<bit_vector_small>(std::move(valid_edges));
+                break;
+            }
+            case BOSS::State::INTERLEAVED: {
+                valid_edges_ = std::make_unique<bit_vector_stat>(std::move(valid_edges));
+                break;
+            }
+        }
+    }
+
+    assert(!valid_edges_.get() || !(*valid_edges_)[0]);
+    assert(!valid_edges_.get() || valid_edges_->size() == boss_graph_->num_edges() + 1);
+
+    for (uint64_t new_boss_edge : boss_edges_inserted) {
+        on_insertion(boss_to_kmer_index(new_boss_edge));
+    }
+}
+
 std::string DBGSuccinct::get_node_sequence(node_index node) const {
     assert(node > 0 && node <= num_nodes());
 
@@ -393,6 +471,25 @@ void DBGSuccinct::map_to_nodes(std::string_view sequence,
     if (sequence.size() < get_k())
         return;
 
+    if (mode_ == CANONICAL && !bloom_filter_) {
+        std::vector<BOSS::TAlphabet> complement(boss_graph_->alph_size + 1);
+        std::iota(complement.begin(), complement.end(), 0);
+        for (BOSS::TAlphabet c = 1; c < boss_graph_->alph_size; ++c) {
+            complement[c] = boss_graph_->encode(::complement(boss_graph_->decode(c)));
+        }
+
+        // the forward and the reverse complement k-mers are mapped in one pass
+        boss_graph_->map_to_edges_with_rc(boss_graph_->encode(sequence), complement,
+            [&](BOSS::edge_index edge, BOSS::edge_index rc_edge) {
+                // the definition of a canonical k-mer is redefined:
+                //      use k-mer with smaller index in the BOSS table.
+                callback(boss_to_kmer_index(rc_edge ? std::min(edge, rc_edge) : edge));
+            },
+            terminate
+        );
+        return;
+    }
+
     auto is_missing = get_missing_kmer_skipper(bloom_filter_.get(), sequence);
 
     if (mode_ == CANONICAL) {
@@ -459,6 +556,52 @@ void DBGSuccinct::map_to_nodes(std::string_view sequence,
     }
 }
 
+std::vector<std::vector<DBGSuccinct::node_index>> DBGSuccinct
+::map_to_nodes_sequentially_batch(const std::vector<std::string_view> &sequences) const {
+    if (bloom_filter_)
+        return DeBruijnGraph::map_to_nodes_sequentially_batch(sequences);
+
+    std::vector<std::vector<node_index>> nodes = boss_graph_->map_to_edges_batch(sequences);
+    for (auto &path : nodes) {
+        for (auto &node : path) {
+            node = boss_to_kmer_index(node);
+        }
+    }
+    return nodes;
+}
+
+std::vector<std::vector<DBGSuccinct::node_index>> DBGSuccinct
+::map_to_nodes_batch(const std::vector<std::string_view> &sequences) const {
+    if (mode_ != CANONICAL)
+        return map_to_nodes_sequentially_batch(sequences);
+
+    if (bloom_filter_)
+        return DeBruijnGraph::map_to_nodes_batch(sequences);
+
+    // search the reverse complements in the same batch
+    std::vector<std::string> rev_compl(sequences.begin(), sequences.end());
+    std::vector<std::string_view> batch(sequences.begin(), sequences.end());
+    batch.reserve(sequences.size() * 2);
+    for (std::string &sequence : rev_compl) {
+        reverse_complement(sequence.begin(), sequence.end());
+        batch.push_back(sequence);
+    }
+
+    std::vector<std::vector<node_index>> nodes = boss_graph_->map_to_edges_batch(batch);
+    for (size_t i = 0; i < sequences.size(); ++i) {
+        auto &path = nodes[i];
+        const auto &rc_path = nodes[sequences.size() + i];
+        assert(path.size() == rc_path.size());
+        for (size_t j = 0; j < path.size(); ++j) {
+            // the definition of a canonical k-mer is redefined:
+            //      use k-mer with smaller index in the BOSS table.
+            path[j] = boss_to_kmer_index(std::min(path[j], rc_path[path.size() - 1 - j]));
+        }
+    }
+    nodes.resize(sequences.size());
+    return nodes;
+}
+
 void DBGSuccinct::call_sequences(const CallPath &callback,
                                  size_t num_threads,
                                  bool kmers_in_single_form) const {
@@ -689,6 +832,10 @@ bool DBGSuccinct::load(const std::string &filename) {
             valid_edges_.reset(new bit_vector_small());
             break;
         }
+        case BOSS::State::INTERLEAVED: {
+            valid_edges_.reset(new bit_vector_stat());
+            break;
+        }
     }
 
     // load the mask of valid edges (all non-dummy including npos 0)
@@ -763,7 +910,9 @@ void DBGSuccinct::serialize(const std::string &filename) const {
         || (boss_graph_->get_state() == BOSS::State::DYN
                 && dynamic_cast<const bit_vector_dyn*>(valid_edges_.get()))
         || (boss_graph_->get_state() == BOSS::State::SMALL
-                && dynamic_cast<const bit_vector_small*>(valid_edges_.get())));
+                && dynamic_cast<const bit_vector_small*>(valid_edges_.get()))
+        || (boss_graph_->get_state() == BOSS::State::INTERLEAVED
+                && dynamic_cast<const bit_vector_stat*>(valid_edges_.get())));
 
     const auto out_filename = prefix + kDummyMaskExtension;
     std::ofstream out(out_filename, std::ios::binary);
@@ -828,6 +977,12 @@ void DBGSuccinct::switch_state(BOSS::State new_state) {
                 );
                 break;
             }
+            case BOSS::State::INTERLEAVED: {
+                valid_edges_ = std::make_unique<bit_vector_stat>(
+                    valid_edges_->convert_to<bit_vector_stat>()
+                );
+                break;
+            }
         }
     }
 
@@ -847,6 +1002,9 @@ BOSS::State DBGSuccinct::get_state() const {
     assert(!valid_edges_.get()
                 || boss_graph_->get_state() != BOSS::State::SMALL
                 || dynamic_cast<const bit_vector_small*>(valid_edges_.get()));
+    assert(!valid_edges_.get()
+                || boss_graph_->get_state() != BOSS::State::INTERLEAVED
+                || dynamic_cast<const bit_vector_stat*>(valid_edges_.get()));
 
     return boss_graph_->get_state();
 }
@@ -877,6 +1035,10 @@ void DBGSuccinct::mask_dummy_kmers(size_t num_threads, bool with_pruning) {
             valid_edges_ = std::make_unique<bit_vector_small>(std::move(vector_mask));
             break;
         }
+        case BOSS::State::INTERLEAVED: {
+            valid_edges_ = std::make_unique<bit_vector_stat>(std::move(vector_mask));
+            break;
+        }
     }
 
     assert(valid_edges_.get());
@@ -44,6 +44,17 @@ class DBGSuccinct : public DeBruijnGraph {
     virtual void add_sequence(std::string_view sequence,
                               const std::function<void(node_index)> &on_insertion = [](node_index) {}) override final;
 
+    // Insert a batch of sequences by merging their sorted k-mers into the BOSS
+    // table in a single pass (see BOSS::add_sequences), which is much faster
+    // than calling add_sequence for each sequence. Unlike add_sequence, works
+    // in any state. The callback |on_insertion| is invoked for all new node
+    // indexes, as in add_sequence, in increasing order of the final indexes.
+    // If dummy k-mers are masked out, the new dummy k-mers stay masked out
+    // and are not reported.
+    void add_sequences(std::vector<std::string>&& sequences,
+                       const std::function<void(node_index)> &on_insertion = [](node_index) {},
+                       size_t num_threads = 1);
+
     virtual std::string get_node_sequence(node_index node) const override final;
 
     // Traverse graph mapping sequence to the graph nodes
@@ -60,6 +71,14 @@ class DBGSuccinct : public DeBruijnGraph {
                                            const std::function<void(node_index)> &callback,
                                            const std::function<bool()> &terminate = [](){ return false; }) const override final;
 
+    // Map the sequences with interleaved lookups in the BOSS table (see
+    // BOSS::map_to_edges_batch). If a Bloom filter is loaded, the sequences
+    // are mapped one by one, skipping the k-mers rejected by the filter.
+    virtual std::vector<std::vector<node_index>>
+    map_to_nodes_batch(const std::vector<std::string_view> &sequences) const override;
+    virtual std::vector<std::vector<node_index>>
+    map_to_nodes_sequentially_batch(const std::vector<std::string_view> &sequences) const override;
+
     virtual void call_sequences(const CallPath &callback,
                                 size_t num_threads = 1,
                                 bool kmers_in_single_form = false) const override final;
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "sketch/tensor.hpp"
+#include "sketch/tensor_slide.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace ts { // ts = Tensor Sketch
+
+/**
+ * Computes multi-window tensor sketches of k-mers. Each k-mer is split into windows of
+ * length #window() starting every #stride() characters, the windows are sketched with a
+ * Tensor sketch and the sketches are concatenated into a feature vector of size #dim().
+ *
+ * One Tensor sketcher is kept per repeat (the repeat index is used as the seed), so the
+ * random hash and sign tables are generated only once. The object is immutable after
+ * construction and can be shared between threads.
+ *
+ * The feature vectors of all k-mers of a sequence can also be computed in one pass with
+ * #compute_all_into, which sketches every window only once with a sliding tensor sketch.
+ */
+class KmerSketcher {
+  public:
+    static constexpr double kStrideRatio = 0.1;
+    static constexpr double kWindowRatio = 0.2;
+
+    /**
+     * @param alphabet_size the number of elements in the alphabet (e.g. 4 for DNA)
+     * @param embed_dim the dimension of the sketch of a single window
+     * @param tuple_length the length of the subsequences considered for sketching
+     * @param k the length of the k-mers to be sketched
+     * @param num_repeats the number of independent sketchers, seeded with 0, 1, ...
+     */
+    KmerSketcher(uint8_t alphabet_size,
+                 size_t embed_dim,
+                 size_t tuple_length,
+                 uint32_t k,
+                 uint32_t num_repeats)
+          : k_(k),
+            alphabet_size_(alphabet_size),
+            embed_dim_(embed_dim),
+            stride_(kStrideRatio * k),
+            window_(kWindowRatio * k),
+            num_windows_(std::ceil((double)(k - window_ + 1) / stride_)) {
+        assert(stride_ && window_ && "k is too small for sketching");
+        tensors_.reserve(num_repeats);
+        for (uint32_t n_repeat = 0; n_repeat < num_repeats; ++n_repeat) {
+            // the sliding sketcher is initialized with the same seed, so it shares the
+            // hash functions of the Tensor sketcher and computes the same window sketches
+            tensors_.emplace_back(alphabet_size, embed_dim, tuple_length,
+                                  window_, 1, n_repeat);
+        }
+    }
+
+    uint32_t get_k() const { return k_; }
+    uint32_t stride() const { return stride_; }
+    uint32_t window() const { return window_; }
+    uint32_t num_windows() const { return num_windows_; }
+    uint32_t num_repeats() const { return tensors_.size(); }
+    size_t embed_dim() const { return embed_dim_; }
+    /** The dimension of the feature vector of a k-mer */
+    size_t dim() const { return embed_dim_ * num_windows_; }
+
+    /** Size of the scratch buffer required by #compute_into */
+    size_t scratch_size() const { return tensors_.empty() ? 0 : tensors_[0].scratch_size(); }
+
+    /** Size of the scratch buffer required by #compute_all_into */
+    size_t sliding_scratch_size() const {
+        return tensors_.empty() ? 0 : std::max(tensors_[0].scratch_size(),
+                                               tensors_[0].window_scratch_size());
+    }
+
+    const Tensor<uint8_t>& get_tensor(uint32_t repeat) const { return tensors_.at(repeat); }
+
+    /**
+     * Computes the feature vector of the k-mer kmer[0], ..., kmer[k - 1] for the repeat
+     * |repeat| into sketch[0], ..., sketch[dim() - 1]. Does not allocate any memory.
+     * @param scratch a caller-owned buffer of at least #scratch_size() elements
+     */
+    void compute_into(const uint8_t *kmer, uint32_t repeat, float *sketch, double *scratch) const {
+        assert(repeat < tensors_.size());
+        const auto &tensor = tensors_[repeat];
+        for (uint32_t mmer_start = 0; mmer_start < k_ - window_ + 1; mmer_start += stride_) {
+            tensor.compute_into(kmer + mmer_start, window_, sketch, scratch);
+            sketch += embed_dim_;
+        }
+    }
+
+    /**
+     * Computes the feature vectors of all k-mers seq[i], ..., seq[i + k - 1] of a sequence
+     * for the repeat |repeat|, and writes the i-th one into sketches[i * dim()], ...
+     * The sketch of every window is computed only once, in a single streaming pass with
+     * a sliding tensor sketch, and the feature vectors are assembled from the window sketches.
+     * Windows containing characters outside of the alphabet are sketched from scratch, in
+     * the same way as in #compute_into.
+     * @param sketches output buffer of at least (len - k + 1) * dim() elements
+     * @param window_sketches buffer of at least (len - window() + 1) * embed_dim() elements
+     * @param scratch a caller-owned buffer of at least #sliding_scratch_size() elements
+     */
+    void compute_all_into(const uint8_t *seq,
+                          size_t len,
+                          uint32_t repeat,
+                          float *sketches,
+                          float *window_sketches,
+                          double *scratch) const {
+        assert(repeat < tensors_.size());
+        if (len < k_)
+            return;
+
+        const auto &tensor = tensors_[repeat];
+        const size_t num_window_starts = len - window_ + 1;
+
+        // windows with start in [0, computed_end) are already sketched
+        size_t computed_end = 0;
+        size_t run_begin = 0;
+        for (size_t i = 0; i <= len; ++i) {
+            if (i < len && seq[i] < alphabet_size_)
+                continue;
+
+            // sketch all windows in the run of valid characters seq[run_begin, i)
+            if (i - run_begin >= window_) {
+                tensor.compute_windows_into(seq + run_begin, i - run_begin,
+                                            window_sketches + run_begin * embed_dim_,
+                                            scratch);
+            }
+            computed_end = std::max(computed_end, i >= window_ ? i - window_ + 1 : 0);
+
+            // the windows overlapping the invalid character seq[i] are sketched directly
+            for ( ; computed_end < std::min(i + 1, num_window_starts); ++computed_end) {
+                tensor.compute_into(seq + computed_end, window_,
+                                    window_sketches + computed_end * embed_dim_, scratch);
+            }
+
+            run_begin = i + 1;
+        }
+
+        for (size_t kmer_start = 0; kmer_start + k_ <= len; ++kmer_start) {
+            float *sketch = sketches + kmer_start * dim();
+            for (uint32_t mmer_start = 0; mmer_start < k_ - window_ + 1; mmer_start += stride_) {
+                const float *window_sketch = window_sketches + (kmer_start + mmer_start) * embed_dim_;
+                sketch = std::copy(window_sketch, window_sketch + embed_dim_, sketch);
+            }
+        }
+    }
+
+  private:
+    uint32_t k_;
+    uint8_t alphabet_size_;
+    size_t embed_dim_;
+    uint32_t stride_;
+    uint32_t window_;
+    uint32_t num_windows_;
+    std::vector<TensorSlide<uint8_t>> tensors_;
+};
+
+} // namespace ts
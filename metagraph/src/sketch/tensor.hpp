@@ -2,11 +2,13 @@
 
 #include "immintrin.h" // for AVX
 #include "nmmintrin.h" // for SSE4.2
+#include "common/utils/simd_utils.hpp"
 #include "sketch//sketch_base.hpp"
 #include "util/multivec.hpp"
 #include "util/timer.hpp"
 #include "util/utils.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <random>
@@ -105,6 +107,49 @@ class Tensor : public SketchBase<std::vector<double>, false> {
         return sketch;
     }
 
+    /** Size of the scratch buffer required by #compute_into */
+    size_t scratch_size() const { return 2 * (subsequence_len + 1) * sketch_dim; }
+
+    /**
+     * Computes the sketch of seq[0], ..., seq[len - 1] into sketch[0], ..., sketch[D - 1],
+     * where D is #sketch_dim. Equivalent to #compute, but does not allocate any memory, so
+     * it can be used concurrently by multiple threads on the same object.
+     * @param scratch a caller-owned buffer of at least #scratch_size() elements
+     */
+    template <typename T>
+    void compute_into(const seq_type *seq, size_t len, T *sketch, double *scratch) const {
+        // Tp[p] = scratch[p * D], Tm[p] = scratch[(t + 1 + p) * D]
+        double *Tp = scratch;
+        double *Tm = scratch + (subsequence_len + 1) * sketch_dim;
+        std::fill(scratch, scratch + scratch_size(), 0);
+
+        Tp[0] = 1;
+        for (uint32_t i = 0; i < len; i++) {
+            const seq_type c = seq[i];
+            if (c < 0 or c >= alphabet_size) {
+                continue;
+            }
+            for (uint32_t p = std::min(i + 1, (uint32_t)subsequence_len); p >= 1; --p) {
+                const double z = p / (i + 1.0);
+                const seq_type r = hashes[p - 1][c];
+                double *tp = Tp + p * sketch_dim;
+                double *tm = Tm + p * sketch_dim;
+                if (signs[p - 1][c]) {
+                    shift_sum_inplace(tp, tp - sketch_dim, sketch_dim, r, z);
+                    shift_sum_inplace(tm, tm - sketch_dim, sketch_dim, r, z);
+                } else {
+                    shift_sum_inplace(tp, tm - sketch_dim, sketch_dim, r, z);
+                    shift_sum_inplace(tm, tp - sketch_dim, sketch_dim, r, z);
+                }
+            }
+        }
+        const double *tp = Tp + subsequence_len * sketch_dim;
+        const double *tm = Tm + subsequence_len * sketch_dim;
+        for (uint32_t m = 0; m < sketch_dim; m++) {
+            sketch[m] = tp[m] - tm[m];
+        }
+    }
+
     /** Sets the hash and sign functions to predetermined values for testing */
     void set_hashes_for_testing(const Vec2D<seq_type> &h, const Vec2D<bool> &s) {
         hashes = h;
@@ -116,19 +161,49 @@ class Tensor : public SketchBase<std::vector<double>, false> {
         return l2_dist(a, b);
     }
 
+    /**
+     * Computes (1-z)*a + z*b_shift for raw buffers of length #len, where b_shift is b
+     * cyclically shifted to the right by #shift, i.e. b_shift[i] = b[(len + i - shift) % len].
+     * The cyclic shift is split into two contiguous spans, so that no modulo is needed and
+     * the spans can be processed with vector instructions.
+     */
+    template <typename T>
+    static void shift_sum_inplace(T *a, const T *b, size_t len, seq_type shift, T z) {
+        assert(shift < len);
+        // a[0, shift) is combined with b[len - shift, len)
+        convex_sum_inplace(a, b + len - shift, shift, z);
+        // a[shift, len) is combined with b[0, len - shift)
+        convex_sum_inplace(a + shift, b, len - shift, z);
+    }
+
+    /** Reference implementation of #shift_sum_inplace */
+    template <typename T>
+    static void shift_sum_inplace_scalar(T *a, const T *b, size_t len, seq_type shift, T z) {
+        for (size_t i = 0; i < len; i++) {
+            a[i] = z * b[(len + i - shift) % len] + (1 - z) * a[i];
+        }
+    }
+
   protected:
     /** Computes (1-z)*a + z*b_shift */
     void shift_sum_inplace(std::vector<double> &a,
                            const std::vector<double> &b,
                            seq_type shift,
-                           double z) {
+                           double z) const {
         assert(a.size() == b.size());
-        size_t len = a.size();
-        for (uint32_t i = 0; i < len; i++) {
-            a[i] =  z * b[(len + i - shift) % len] + (1 - z) * a[i];
-            /* a[i] =  b[(len + i - shift) % len] + a[i]; */
-//            assert(a[i] <= 1 + 1e-5 && a[i] >= -1e-5);
+        shift_sum_inplace(a.data(), b.data(), a.size(), shift, z);
+    }
+
+    /** Computes a[i] = z * b[i] + (1 - z) * a[i] for all i in [0, len) */
+    template <typename T>
+    static void convex_sum_inplace(T *a, const T *b, size_t len, T z) {
+#ifdef __AVX2__
+        convex_sum_inplace_avx2(a, b, len, z);
+#else
+        for (size_t i = 0; i < len; i++) {
+            a[i] = z * b[i] + (1 - z) * a[i];
         }
+#endif
     }
 
     /** Size of the alphabet over which sequences to be sketched are defined, e.g. 4 for DNA */
@@ -114,6 +114,85 @@ class TensorSlide : public Tensor<seq_type> {
         return sketches;
     }
 
+    /** Size of the scratch buffer required by #compute_windows_into */
+    size_t window_scratch_size() const {
+        return 2 * (this->subsequence_len + 2) * (this->subsequence_len + 1) * this->sketch_dim;
+    }
+
+    /**
+     * Computes sliding sketches for seq[0], ..., seq[len - 1] in a single pass, like
+     * #compute, but writes the j-th sketch into sketches[j * D], ..., sketches[(j + 1) * D - 1],
+     * where D is #sketch_dim. Does not allocate any memory.
+     * All characters in the sequence must be smaller than the alphabet size.
+     * @param scratch a caller-owned buffer of at least #window_scratch_size() elements
+     * @return the number of sketches computed
+     */
+    template <typename T>
+    size_t compute_windows_into(const seq_type *seq, size_t len, T *sketches, double *scratch) const {
+        const uint32_t tup_len = this->subsequence_len;
+        const size_t dim = this->sketch_dim;
+        if (len < tup_len)
+            return 0;
+
+        // T1[p][q] = T1 + (p * (tup_len + 1) + q) * dim, same for T2
+        double *T1 = scratch;
+        double *T2 = scratch + (tup_len + 2) * (tup_len + 1) * dim;
+        auto at = [&](double *table, uint32_t p, uint32_t q) {
+            return table + (p * (tup_len + 1) + q) * dim;
+        };
+        std::fill(scratch, scratch + window_scratch_size(), 0);
+
+        for (uint32_t p = 0; p <= tup_len; p++) {
+            at(T1, p + 1, p)[0] = 1;
+        }
+
+        size_t num_sketches = 0;
+        for (uint32_t i = 0; i < len; i++) {
+            assert(seq[i] < this->alphabet_size);
+            for (uint32_t p = 1; p <= tup_len; p++) {
+                for (uint32_t q = std::min(p + i, tup_len); q >= p; q--) {
+                    double z = (double)(q - p + 1) / std::min(i + 1, win_len + 1);
+                    auto r = this->hashes[q - 1][seq[i]];
+                    if (this->signs[q - 1][seq[i]]) {
+                        this->shift_sum_inplace(at(T1, p, q), at(T1, p, q - 1), dim, r, z);
+                        this->shift_sum_inplace(at(T2, p, q), at(T2, p, q - 1), dim, r, z);
+                    } else {
+                        this->shift_sum_inplace(at(T1, p, q), at(T2, p, q - 1), dim, r, z);
+                        this->shift_sum_inplace(at(T2, p, q), at(T1, p, q - 1), dim, r, z);
+                    }
+                }
+            }
+
+            if (i >= win_len) { // only start deleting from front after reaching #win_len
+                uint32_t ws = i - win_len; // the element to be removed from the sketch
+                for (uint32_t diff = 0; diff < tup_len; ++diff) {
+                    double z = (double)(diff + 1) / (win_len - diff);
+                    for (uint32_t p = 1; p <= tup_len - diff; p++) {
+                        auto r = this->hashes[p - 1][seq[ws]];
+                        uint32_t q = p + diff;
+                        if (this->signs[p - 1][seq[ws]]) {
+                            this->shift_sum_inplace(at(T1, p, q), at(T1, p + 1, q), dim, r, -z);
+                            this->shift_sum_inplace(at(T2, p, q), at(T2, p + 1, q), dim, r, -z);
+                        } else {
+                            this->shift_sum_inplace(at(T1, p, q), at(T2, p + 1, q), dim, r, -z);
+                            this->shift_sum_inplace(at(T2, p, q), at(T1, p + 1, q), dim, r, -z);
+                        }
+                    }
+                }
+            }
+
+            if (i >= win_len - 1 && (i + 1) % stride == 0) { // save a sketch every stride times
+                const double *a = at(T1, 1, tup_len);
+                const double *b = at(T2, 1, tup_len);
+                T *sketch = sketches + num_sketches * dim;
+                for (uint32_t m = 0; m < dim; ++m) {
+                    sketch[m] = a[m] - b[m];
+                }
+                num_sketches++;
+            }
+        }
+        return num_sketches;
+    }
 
     uint64_t discretize(std::vector<double> x, std::vector<std::vector<double>> G) {
         uint64_t ret = 0;
@@ -0,0 +1,86 @@
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "annotation/binary_matrix/row_diff/row_cache.hpp"
+
+namespace {
+using namespace mtg;
+using annot::binmat::RowCache;
+
+TEST(RowCache, GetPut) {
+    RowCache cache(1'000'000);
+    RowCache::SetBitPositions row;
+    EXPECT_FALSE(cache.get(1, &row));
+
+    cache.put(1, { 1, 5, 7 });
+    cache.put(2, {});
+    ASSERT_TRUE(cache.get(1, &row));
+    EXPECT_EQ(RowCache::SetBitPositions({ 1, 5, 7 }), row);
+    ASSERT_TRUE(cache.get(2, &row));
+    EXPECT_EQ(RowCache::SetBitPositions(), row);
+
+    // lookups on row-diff paths are counted separately
+    EXPECT_TRUE(cache.get(1, &row, false));
+    EXPECT_FALSE(cache.get(3, &row, false));
+
+    auto stats = cache.get_stats();
+    EXPECT_EQ(2u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(1u, stats.path_hits);
+    EXPECT_EQ(2u, stats.num_rows);
+    EXPECT_LT(0u, stats.num_bytes);
+
+    cache.clear();
+    EXPECT_FALSE(cache.get(1, &row));
+    EXPECT_EQ(0u, cache.get_stats().num_rows);
+}
+
+TEST(RowCache, EvictLeastRecentlyUsed) {
+    // a single shard
+    RowCache cache(10'000, 1);
+    for (uint64_t i = 0; i < 10'000; ++i) {
+        cache.put(i, { i, i + 1 });
+        // keep the first row in use
+        RowCache::SetBitPositions row;
+        ASSERT_TRUE(cache.get(0, &row));
+    }
+
+    auto stats = cache.get_stats();
+    EXPECT_GE(10'000u, stats.num_bytes);
+    EXPECT_LT(10u, stats.num_rows);
+    EXPECT_GT(10'000u, stats.num_rows);
+
+    RowCache::SetBitPositions row;
+    EXPECT_TRUE(cache.get(0, &row));
+    EXPECT_TRUE(cache.get(9'999, &row));
+    EXPECT_FALSE(cache.get(1, &row));
+}
+
+TEST(RowCache, ConcurrentAccess) {
+    RowCache cache(100'000);
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < 8; ++t) {
+        threads.emplace_back([&cache,t]() {
+            RowCache::SetBitPositions row;
+            for (uint64_t i = 0; i < 100'000; ++i) {
+                uint64_t row_id = (i * 7 + t) % 1'000;
+                if (cache.get(row_id, &row)) {
+                    ASSERT_EQ(RowCache::SetBitPositions({ row_id, row_id + 1 }), row);
+                } else {
+                    cache.put(row_id, { row_id, row_id + 1 });
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    auto stats = cache.get_stats();
+    EXPECT_EQ(800'000u, stats.hits + stats.misses);
+    EXPECT_GE(100'000u, stats.num_bytes);
+}
+
+} // namespace
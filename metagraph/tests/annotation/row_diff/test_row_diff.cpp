@@ -118,6 +118,61 @@ TEST(RowDiff, GetRows) {
     ASSERT_THAT(rows[11], ElementsAre(0));
 }
 
+TEST(RowDiff, GetRowsCached) {
+    // build graph
+    graph::DBGSuccinct graph(4);
+    graph.add_sequence("ACTAGCTAGCTAGCTAGCTAGC");
+    graph.add_sequence("ACTCTAG");
+
+    // build annotation
+    sdsl::bit_vector bterminal = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0 };
+    anchor_bv_type terminal(bterminal);
+    utils::TempFile fterm_temp;
+    std::ofstream fterm(fterm_temp.name(), ios::binary);
+    terminal.serialize(fterm);
+    fterm.flush();
+
+    std::vector<std::unique_ptr<bit_vector>> cols(2);
+    cols[0] = std::make_unique<bit_vector_sd>(
+            std::initializer_list<bool>({ 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0  }));
+    cols[1] = std::make_unique<bit_vector_sd>(
+            std::initializer_list<bool>({ 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1 }));
+
+    annot::binmat::ColumnMajor mat(std::move(cols));
+
+    annot::binmat::RowDiff annot(&graph, std::move(mat));
+    annot.load_anchor(fterm_temp.name());
+
+    std::vector<annot::binmat::BinaryMatrix::Row> row_ids { 3, 5, 6, 7, 8, 9, 10, 11 };
+    auto expected = annot.get_rows(row_ids);
+
+    auto row_cache = std::make_shared<annot::binmat::RowCache>(1'000'000);
+    annot.set_row_cache(row_cache);
+
+    // the rows on the row-diff paths are taken from the cache
+    EXPECT_EQ(expected[1], annot.get_row(5));
+    EXPECT_EQ(expected[3], annot.get_row(7));
+    EXPECT_EQ(expected, annot.get_rows(row_ids));
+    auto reversed = annot.get_rows({ 11, 10, 9, 8, 7, 6, 5, 3 });
+    std::reverse(reversed.begin(), reversed.end());
+    EXPECT_EQ(expected, reversed);
+    for (size_t i = 0; i < row_ids.size(); ++i) {
+        EXPECT_EQ(expected[i], annot.get_row(row_ids[i]));
+    }
+
+    auto stats = row_cache->get_stats();
+    EXPECT_EQ(row_ids.size(), stats.num_rows);
+    EXPECT_LT(0u, stats.hits);
+    EXPECT_LT(0u, stats.misses);
+
+    // an empty cache keeps nothing
+    row_cache = std::make_shared<annot::binmat::RowCache>(0);
+    annot.set_row_cache(row_cache);
+    EXPECT_EQ(expected, annot.get_rows(row_ids));
+    EXPECT_EQ(0u, row_cache->get_stats().num_rows);
+    EXPECT_EQ(0u, row_cache->get_stats().hits);
+}
+
 /**
  * Tests annotations on the graph in
  * https://docs.google.com/document/d/1e0MFgZRJfmDUSvmDPuC_lvnnWA0VKm5hPdzM8mdrHMM/edit#bookmark=id.ciri4266pkc4
@@ -3,11 +3,13 @@
 
 #include <zlib.h>
 #include <htslib/kseq.h>
+#include <random>
 #include <unordered_set>
 
 #include "graph/representation/succinct/boss.hpp"
 #include "graph/representation/succinct/boss_construct.hpp"
 #include "common/algorithms.hpp"
+#include "common/seq_tools/reverse_complement.hpp"
 
 
 namespace {
@@ -83,6 +85,11 @@ void test_graph(BOSS *graph, const std::string &last,
     test_graph(graph, last, W, F, BOSS::State::DYN);
     test_graph(graph, last, W, F, BOSS::State::SMALL);
     test_graph(graph, last, W, F, BOSS::State::DYN);
+    test_graph(graph, last, W, F, BOSS::State::INTERLEAVED);
+    test_graph(graph, last, W, F, BOSS::State::INTERLEAVED);
+    test_graph(graph, last, W, F, BOSS::State::STAT);
+    test_graph(graph, last, W, F, BOSS::State::INTERLEAVED);
+    test_graph(graph, last, W, F, BOSS::State::DYN);
 }
 
 
@@ -243,6 +250,40 @@ TEST(BOSS, Serialization) {
     delete graph;
 }
 
+TEST(BOSS, SerializationInterleaved) {
+    BOSS graph(5);
+    BOSS reference(5);
+    for (const auto &sequence : { "AAAAAACCCCCCTTTTTTGGGGGGNACGTACGTAC",
+                                  "ACGTTTTGGGGGAACCATTTTTTGGACATGAAAAAAAAAAAA" }) {
+        graph.add_sequence(sequence);
+        reference.add_sequence(sequence);
+    }
+    reference.switch_state(BOSS::State::STAT);
+
+    graph.switch_state(BOSS::State::INTERLEAVED);
+    graph.serialize(test_dump_basename);
+
+    BOSS loaded_graph;
+    ASSERT_TRUE(loaded_graph.load(test_dump_basename)) << "Can't load the graph";
+    EXPECT_EQ(BOSS::State::INTERLEAVED, loaded_graph.get_state());
+    EXPECT_EQ(reference, loaded_graph) << "Loaded graph differs";
+
+    for (uint64_t i = 1; i < loaded_graph.num_edges() + 1; ++i) {
+        EXPECT_EQ(reference.get_W(i), loaded_graph.get_W(i));
+        EXPECT_EQ(reference.get_last(i), loaded_graph.get_last(i));
+        EXPECT_EQ(reference.rank_last(i), loaded_graph.rank_last(i));
+        for (BOSS::TAlphabet c = 0; c < 2 * reference.alph_size; ++c) {
+            EXPECT_EQ(reference.rank_W(i, c), loaded_graph.rank_W(i, c));
+        }
+        if (reference.get_W(i))
+            EXPECT_EQ(fwd(reference, i), fwd(loaded_graph, i));
+        EXPECT_EQ(reference.bwd(i), loaded_graph.bwd(i));
+    }
+
+    loaded_graph.switch_state(BOSS::State::STAT);
+    EXPECT_EQ(reference, loaded_graph);
+}
+
 TEST(BOSS, AddSequenceSimplePath) {
     for (size_t k = 1; k < 10; ++k) {
         BOSS graph(k);
@@ -790,6 +831,74 @@ TEST(BOSS, RemoveDummyEdgesParallel) {
     }
 }
 
+TEST(BOSS, RemoveDummyEdgesManyBlocksParallel) {
+    std::mt19937 gen(42);
+    std::vector<std::string> sequences(500);
+    for (auto &sequence : sequences) {
+        sequence.resize(50);
+        for (char &c : sequence) {
+            c = "ACGT"[gen() % 4];
+        }
+    }
+
+    for (size_t k : { 3, 7, 12 }) {
+        BOSSConstructor constructor(k);
+        constructor.add_sequences(std::vector<std::string>(sequences));
+        BOSS graph(&constructor);
+
+        for (size_t num_threads : { 1, 4 }) {
+            BOSS dynamic_graph(k);
+            for (const auto &sequence : sequences) {
+                dynamic_graph.add_sequence(sequence);
+            }
+            ASSERT_EQ(graph, dynamic_graph);
+
+            dynamic_graph.erase_redundant_dummy_edges(NULL, num_threads);
+
+            EXPECT_TRUE(graph.equals_internally(dynamic_graph)) << k << " " << num_threads;
+            EXPECT_EQ(graph, dynamic_graph);
+        }
+    }
+}
+
+TEST(BOSS, AddSequencesBatch) {
+    std::mt19937 gen(42);
+    std::vector<std::string> sequences(200);
+    for (auto &sequence : sequences) {
+        sequence.resize(50);
+        for (char &c : sequence) {
+            c = "ACGT"[gen() % 4];
+        }
+    }
+    std::vector<std::string> first(sequences.begin(), sequences.begin() + 100);
+    // the batch overlaps with the sequences already in the graph
+    std::vector<std::string> batch(sequences.begin() + 50, sequences.end());
+
+    for (size_t k : { 1, 4, 12 }) {
+        BOSSConstructor constructor(k);
+        constructor.add_sequences(std::vector<std::string>(sequences));
+        BOSS expected(&constructor);
+
+        for (auto state : { BOSS::State::DYN, BOSS::State::STAT, BOSS::State::FAST }) {
+            BOSS graph(k);
+            for (const auto &sequence : first) {
+                graph.add_sequence(sequence);
+            }
+            graph.switch_state(state);
+            uint64_t old_num_edges = graph.num_edges();
+
+            std::vector<BOSS::edge_index> edges_inserted;
+            graph.add_sequences(std::vector<std::string>(batch), false, &edges_inserted, 2);
+
+            EXPECT_EQ(state, graph.get_state());
+            EXPECT_TRUE(graph.is_valid());
+            EXPECT_EQ(expected, graph);
+            EXPECT_EQ(old_num_edges + edges_inserted.size(), graph.num_edges());
+            EXPECT_TRUE(std::is_sorted(edges_inserted.begin(), edges_inserted.end()));
+        }
+    }
+}
+
 TEST(BOSS, AddSequenceBugRevealingTestcase) {
     BOSS graph(1);
     graph.add_sequence("CTGAG", false);
@@ -914,6 +1023,203 @@ TEST(BOSS, AppendSequenceAnyKmerSize) {
     }
 }
 
+TEST(BOSS, MapToEdgesBatch) {
+    std::mt19937 gen(42);
+    auto random_sequence = [&](size_t length) {
+        std::string sequence(length, 'A');
+        for (char &c : sequence) {
+            c = "ACGT"[gen() % 4];
+        }
+        return sequence;
+    };
+
+    std::vector<std::string> sequences;
+    for (size_t i = 0; i < 10; ++i) {
+        sequences.push_back(random_sequence(1000));
+    }
+
+    // queries sampled from the graph, random queries, queries with invalid
+    // characters, and queries too short to contain a k-mer
+    std::vector<std::string> queries;
+    for (const auto &sequence : sequences) {
+        queries.push_back(sequence.substr(gen() % 500, 100));
+        queries.push_back(sequence.substr(0, 700) + random_sequence(50) + sequence.substr(750));
+    }
+    queries.push_back(random_sequence(300));
+    queries.push_back(sequences[0].substr(0, 40) + "N" + sequences[0].substr(41, 300));
+    queries.push_back("NNNN");
+    queries.push_back("");
+    queries.push_back(sequences[1].substr(0, 5));
+
+    std::vector<std::string_view> batch(queries.begin(), queries.end());
+
+    for (size_t k : { 1, 5, 12, 31 }) {
+        BOSS graph(k);
+        for (const auto &sequence : sequences) {
+            graph.add_sequence(sequence);
+        }
+
+        for (BOSS::State state : { BOSS::State::DYN, BOSS::State::STAT,
+                                   BOSS::State::FAST, BOSS::State::SMALL,
+                                   BOSS::State::INTERLEAVED }) {
+            graph.switch_state(state);
+            for (size_t suffix_length : { 0, 1, 3 }) {
+                if (suffix_length > k)
+                    continue;
+
+                if (suffix_length && state == BOSS::State::STAT)
+                    graph.index_suffix_ranges(suffix_length);
+
+                auto edges = graph.map_to_edges_batch(batch);
+                ASSERT_EQ(queries.size(), edges.size());
+                for (size_t i = 0; i < queries.size(); ++i) {
+                    EXPECT_EQ(graph.map_to_edges(queries[i]), edges[i])
+                        << "k: " << k << ", state: " << state << ", query: " << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(BOSS, IndexSparseSuffixRanges) {
+    std::mt19937 gen(42);
+    std::vector<std::string> sequences;
+    for (size_t i = 0; i < 10; ++i) {
+        std::string sequence(1000, 'A');
+        for (char &c : sequence) {
+            c = "ACGT"[gen() % 4];
+        }
+        sequences.push_back(sequence);
+    }
+
+    std::vector<std::string> queries;
+    for (const auto &sequence : sequences) {
+        queries.push_back(sequence.substr(gen() % 500, 100));
+        queries.push_back(sequence.substr(0, 300) + "ACGTTGCA" + sequence.substr(500, 200));
+    }
+
+    for (size_t k : { 12, 20 }) {
+        BOSS graph(k);
+        for (const auto &sequence : sequences) {
+            graph.add_sequence(sequence);
+        }
+        graph.switch_state(BOSS::State::STAT);
+
+        std::vector<std::vector<BOSS::edge_index>> expected;
+        for (const auto &query : queries) {
+            expected.push_back(graph.map_to_edges(query));
+        }
+        std::vector<std::string> node_strs;
+        for (BOSS::edge_index i = 1; i < graph.num_edges() + 1; ++i) {
+            node_strs.push_back(graph.get_node_str(i));
+        }
+
+        // the dense index for short suffixes and the sparse one for long suffixes
+        for (size_t suffix_length : { 4, 8, 12 }) {
+            for (size_t num_threads : { 1, 4 }) {
+                graph.index_suffix_ranges(suffix_length, num_threads);
+                ASSERT_EQ(suffix_length, graph.get_indexed_suffix_length());
+
+                for (size_t i = 0; i < queries.size(); ++i) {
+                    EXPECT_EQ(expected[i], graph.map_to_edges(queries[i]))
+                        << "k: " << k << ", suffix length: " << suffix_length;
+                }
+                for (BOSS::edge_index i = 1; i < graph.num_edges() + 1; ++i) {
+                    ASSERT_EQ(node_strs[i - 1], graph.get_node_str(i));
+                }
+            }
+
+            {
+                std::ofstream out(test_dump_basename, std::ios::binary);
+                graph.serialize(out);
+                graph.serialize_suffix_ranges(out);
+            }
+            BOSS loaded;
+            std::ifstream in(test_dump_basename, std::ios::binary);
+            ASSERT_TRUE(loaded.load(in));
+            ASSERT_TRUE(loaded.load_suffix_ranges(in));
+            EXPECT_EQ(suffix_length, loaded.get_indexed_suffix_length());
+            for (size_t i = 0; i < queries.size(); ++i) {
+                EXPECT_EQ(expected[i], loaded.map_to_edges(queries[i]));
+            }
+        }
+    }
+}
+
+TEST(BOSS, MapToEdgesWithRC) {
+    std::mt19937 gen(42);
+    auto random_sequence = [&](size_t length) {
+        std::string sequence(length, 'A');
+        for (char &c : sequence) {
+            c = "ACGT"[gen() % 4];
+        }
+        return sequence;
+    };
+
+    std::vector<std::string> sequences;
+    for (size_t i = 0; i < 10; ++i) {
+        sequences.push_back(random_sequence(1000));
+    }
+    // repeats give nodes with multiple incoming edges
+    sequences.push_back(sequences[0].substr(100, 200) + random_sequence(20)
+                            + sequences[1].substr(100, 200));
+
+    std::vector<std::string> queries;
+    for (const auto &sequence : sequences) {
+        queries.push_back(sequence.substr(gen() % 500, 100));
+        std::string rev_compl = sequence.substr(0, 700) + random_sequence(50)
+                                    + sequence.substr(750);
+        reverse_complement(rev_compl);
+        queries.push_back(rev_compl);
+    }
+    queries.push_back(random_sequence(300));
+    queries.push_back(sequences[0].substr(0, 40) + "N" + sequences[0].substr(41, 300));
+    queries.push_back("NNNN");
+    queries.push_back("");
+
+    for (size_t k : { 1, 5, 12, 31 }) {
+        BOSS graph(k);
+        for (std::string sequence : sequences) {
+            graph.add_sequence(sequence);
+            reverse_complement(sequence);
+            graph.add_sequence(sequence);
+        }
+
+        std::vector<BOSS::TAlphabet> complement(graph.alph_size + 1);
+        for (BOSS::TAlphabet c = 0; c <= graph.alph_size; ++c) {
+            complement[c] = c && c < graph.alph_size
+                ? graph.encode(::complement(graph.decode(c)))
+                : c;
+        }
+
+        for (BOSS::State state : { BOSS::State::DYN, BOSS::State::STAT,
+                                   BOSS::State::FAST, BOSS::State::SMALL,
+                                   BOSS::State::INTERLEAVED }) {
+            graph.switch_state(state);
+            for (size_t i = 0; i < queries.size(); ++i) {
+                std::string rev_compl = queries[i];
+                reverse_complement(rev_compl);
+                auto expected = graph.map_to_edges(queries[i]);
+                auto expected_rc = graph.map_to_edges(rev_compl);
+                std::reverse(expected_rc.begin(), expected_rc.end());
+
+                std::vector<BOSS::edge_index> edges;
+                std::vector<BOSS::edge_index> rc_edges;
+                graph.map_to_edges_with_rc(graph.encode(queries[i]), complement,
+                    [&](auto edge, auto rc_edge) {
+                        edges.push_back(edge);
+                        rc_edges.push_back(rc_edge);
+                    }
+                );
+                EXPECT_EQ(expected, edges)
+                    << "k: " << k << ", state: " << state << ", query: " << i;
+                EXPECT_EQ(expected_rc, rc_edges)
+                    << "k: " << k << ", state: " << state << ", query: " << i;
+            }
+        }
+    }
+}
+
 TEST(BOSS, CallPathsEmptyGraph) {
     for (size_t k = 1; k < 30; ++k) {
         BOSS empty(k);
@@ -407,6 +407,12 @@ void random_testing_parallel_merge(size_t num_graphs, size_t num_sequences, size
             { test_data_dir + "/1" }
         );
 
+        auto chunk_files = merge_blocks_to_chunk_files(graphs, 0, 1, num_threads,
+                                                       num_bins_per_thread,
+                                                       test_data_dir + "/block");
+        ASSERT_EQ(num_threads * num_bins_per_thread, chunk_files.size());
+        BOSS *streamed_merged = BOSS::Chunk::build_boss_from_chunks(chunk_files);
+
         BOSS result(k);
         for (size_t i = 0; i < graphs.size(); ++i) {
             result.merge(*graphs[i], num_threads);
@@ -418,12 +424,16 @@ void random_testing_parallel_merge(size_t num_graphs, size_t num_sequences, size
         ASSERT_EQ(result, *chunked_merged) << "The first merged graph is:\n"
                                            << *graphs[0];
 
+        ASSERT_EQ(result, *streamed_merged) << "The first merged graph is:\n"
+                                            << *graphs[0];
+
         for (size_t i = 0; i < graphs.size(); ++i) {
             delete graphs[i];
         }
 
         delete merged;
         delete chunked_merged;
+        delete streamed_merged;
     }
 }
 
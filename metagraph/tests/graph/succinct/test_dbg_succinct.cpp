@@ -1,6 +1,7 @@
 #include "graph/representation/succinct/dbg_succinct.hpp"
 
 #include "graph/representation/base/sequence_graph.hpp"
+#include "graph/graph_extensions/node_first_cache.hpp"
 
 #include <gtest/gtest.h>
 
@@ -10,6 +11,9 @@ namespace {
 using namespace mtg;
 using namespace mtg::graph;
 
+const std::string test_data_dir = TEST_DATA_DIR;
+const std::string test_dump_basename = test_data_dir + "/dbg_succinct_dump_test";
+
 TEST(DBGSuccinct, get_degree_with_source_dummy) {
     for (size_t k = 2; k < 10; ++k) {
         auto graph = std::make_unique<DBGSuccinct>(k);
@@ -526,4 +530,177 @@ TEST(DBGSuccinct, CallNodesWithSuffixMultipleInOut) {
     EXPECT_EQ(ref_node_str, node_str) << *graph;
 }
 
+TEST(DBGSuccinct, SerializeAndLoad) {
+    for (auto state : { boss::BOSS::State::STAT,
+                        boss::BOSS::State::FAST,
+                        boss::BOSS::State::SMALL,
+                        boss::BOSS::State::INTERLEAVED }) {
+        DBGSuccinct graph(12, DeBruijnGraph::CANONICAL);
+        graph.add_sequence("AAAAAAAAAAAAAACCCCCCCGTAAGTGGGGTGTAGGATACCCA");
+        graph.add_sequence("CGTAAGTGGGGTGTAGGATACCCATTTGAGAGGAGAGAGAGACGAT");
+        graph.mask_dummy_kmers(1, false);
+        graph.switch_state(state);
+        graph.serialize(test_dump_basename);
+
+        DBGSuccinct loaded(2);
+        ASSERT_TRUE(loaded.load(test_dump_basename));
+        EXPECT_EQ(graph, loaded);
+        EXPECT_EQ(graph.get_mode(), loaded.get_mode());
+        EXPECT_EQ(state, loaded.get_boss().get_state());
+
+        std::string query = "AAAAAAAAAAAAACCCCCCCGTAAGTGGGGTGTAGGATACCCATTTGAGAGG";
+        std::vector<DBGSuccinct::node_index> expected;
+        std::vector<DBGSuccinct::node_index> nodes;
+        graph.map_to_nodes(query, [&](auto node) { expected.push_back(node); });
+        loaded.map_to_nodes(query, [&](auto node) { nodes.push_back(node); });
+        EXPECT_EQ(expected, nodes);
+    }
+
+    DBGSuccinct loaded(2);
+    EXPECT_FALSE(loaded.load(test_data_dir + "/nonexistent_graph"));
+}
+
+TEST(DBGSuccinct, AddSequencesBatch) {
+    const std::vector<std::string> sequences {
+        "AAAAAAAAAAAAAACCCCCCCGTAAGTGGGGTGTAGGATACCCA",
+        "CGTAAGTGGGGTGTAGGATACCCATTTGAGAGGAGAGAGAGACGAT",
+    };
+    const std::vector<std::string> batch {
+        "AAAAAAAAAAAAAACCCCCCCGTAAGTGGGGTGTAGGATACCCATTTTT",
+        "GGGGGGATATATCGCGCGCATAGAT",
+        "TTTGAGAGGAGAGAGAGACGATCCCA",
+        "ACG",
+    };
+    for (auto mode : { DeBruijnGraph::BASIC, DeBruijnGraph::CANONICAL }) {
+        for (bool mask_dummy : { false, true }) {
+            for (auto state : { boss::BOSS::State::DYN,
+                                boss::BOSS::State::STAT,
+                                boss::BOSS::State::FAST }) {
+                DBGSuccinct graph(5, mode);
+                for (const auto &sequence : sequences) {
+                    graph.add_sequence(sequence);
+                }
+                if (mask_dummy)
+                    graph.mask_dummy_kmers(1, false);
+                graph.switch_state(state);
+
+                std::vector<std::string> old_nodes;
+                for (uint64_t node = 1; node <= graph.max_index(); ++node) {
+                    old_nodes.push_back(graph.get_node_sequence(node));
+                }
+
+                std::vector<DBGSuccinct::node_index> inserted;
+                graph.add_sequences(std::vector<std::string>(batch),
+                                    [&](auto node) { inserted.push_back(node); }, 2);
+
+                ASSERT_EQ(state, graph.get_state());
+                ASSERT_TRUE(std::is_sorted(inserted.begin(), inserted.end()));
+                ASSERT_EQ(old_nodes.size() + inserted.size(), graph.max_index());
+
+                // the old nodes keep their order, the new ones are inserted between them
+                std::vector<bool> is_inserted(graph.max_index() + 1, false);
+                for (auto node : inserted) {
+                    is_inserted[node] = true;
+                }
+                auto it = old_nodes.begin();
+                for (uint64_t node = 1; node <= graph.max_index(); ++node) {
+                    if (is_inserted[node])
+                        continue;
+                    // dummy sink k-mers may be replaced by regular ones
+                    if (it->find('$') == std::string::npos)
+                        EXPECT_EQ(*it, graph.get_node_sequence(node));
+                    ++it;
+                }
+
+                for (const auto &sequence : sequences) {
+                    graph.map_to_nodes(sequence, [&](auto node) { EXPECT_NE(0u, node); });
+                }
+                for (const auto &sequence : batch) {
+                    graph.map_to_nodes(sequence, [&](auto node) { EXPECT_NE(0u, node); });
+                }
+
+                if (mask_dummy) {
+                    // the new dummy k-mers stay masked out
+                    for (uint64_t node = 1; node <= graph.max_index(); ++node) {
+                        EXPECT_EQ(std::string::npos, graph.get_node_sequence(node).find('$'));
+                    }
+
+                    DBGSuccinct reference(5, mode);
+                    for (const auto &sequence : sequences) {
+                        reference.add_sequence(sequence);
+                    }
+                    for (const auto &sequence : batch) {
+                        reference.add_sequence(sequence);
+                    }
+                    reference.mask_dummy_kmers(1, false);
+                    EXPECT_EQ(reference.num_nodes(), graph.num_nodes());
+                }
+            }
+        }
+    }
+}
+
+TEST(DBGSuccinct, NodeFirstCacheIndex) {
+    // the cycle is not reachable from the dummy source after pruning
+    const std::string cycle = "AAGCTTGACCATGGTTCA";
+    for (size_t k : { 2, 5, 9 }) {
+        for (bool with_pruning : { false, true }) {
+            DBGSuccinct graph(k);
+            graph.add_sequence("AAAAAAAAAAAAAACCCCCCCGTAAGTGGGGTGTAGGATACCCA");
+            graph.add_sequence("CGTAAGTGGGGTGTAGGATACCCATTTGAGAGGAGAGAGAGACGAT");
+            graph.add_sequence(cycle + cycle.substr(0, k));
+            graph.mask_dummy_kmers(1, with_pruning);
+
+            NodeFirstCache cache(graph);
+            for (size_t num_threads : { 1, 4 }) {
+                NodeFirstCache index(graph);
+                index.index_first_chars(num_threads);
+                ASSERT_TRUE(index.is_indexed());
+                ASSERT_TRUE(index.is_compatible(graph));
+
+                index.serialize(test_dump_basename);
+                NodeFirstCache loaded(graph);
+                ASSERT_TRUE(loaded.load(test_dump_basename));
+                ASSERT_TRUE(loaded.is_compatible(graph));
+
+                graph.call_nodes([&](auto node) {
+                    char first = graph.get_node_sequence(node)[0];
+                    EXPECT_EQ(first, index.get_first_char(node));
+                    EXPECT_EQ(first, loaded.get_first_char(node));
+
+                    std::vector<std::pair<DBGSuccinct::node_index, char>> expected;
+                    std::vector<std::pair<DBGSuccinct::node_index, char>> incoming;
+                    cache.call_incoming_kmers(node, [&](auto prev, char c) {
+                        expected.emplace_back(prev, c);
+                    });
+                    loaded.call_incoming_kmers(node, [&](auto prev, char c) {
+                        incoming.emplace_back(prev, c);
+                    });
+                    EXPECT_EQ(expected, incoming);
+                });
+            }
+        }
+    }
+
+    NodeFirstCache cache;
+    EXPECT_FALSE(cache.load(test_data_dir + "/nonexistent_graph"));
+}
+
+TEST(DBGSuccinct, NodeFirstCacheIndexOtherGraph) {
+    // graphs with the same number of edges
+    DBGSuccinct graph(4);
+    graph.add_sequence("AAAAAAAAC");
+    DBGSuccinct other(4);
+    other.add_sequence("AAAAAAAAG");
+    ASSERT_EQ(graph.get_boss().num_edges(), other.get_boss().num_edges());
+
+    NodeFirstCache index(graph);
+    index.index_first_chars();
+    index.serialize(test_dump_basename);
+
+    NodeFirstCache loaded(other);
+    ASSERT_TRUE(loaded.load(test_dump_basename));
+    EXPECT_FALSE(loaded.is_compatible(other, false));
+}
+
 } // namespace
@@ -0,0 +1,163 @@
+#include <random>
+#include <set>
+
+#include "gtest/gtest.h"
+
+#include "../test_helpers.hpp"
+#include "common/seq_tools/reverse_complement.hpp"
+#include "graph/representation/hash/dbg_hash_fast.hpp"
+#include "graph/representation/hash/dbg_hash_mphf.hpp"
+
+
+namespace {
+
+using namespace mtg;
+using namespace mtg::graph;
+
+const std::string test_data_dir = "../tests/data";
+const std::string test_dump_basename = test_data_dir + "/dump_test_graph";
+
+
+std::vector<std::string> random_sequences(size_t num_sequences, size_t length) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 3);
+    std::vector<std::string> sequences(num_sequences);
+    for (auto &sequence : sequences) {
+        for (size_t i = 0; i < length; ++i) {
+            sequence.push_back("ACGT"[dist(gen)]);
+        }
+    }
+    return sequences;
+}
+
+void check_same_kmers(const DeBruijnGraph &graph, const DBGHashMPHF &static_graph) {
+    ASSERT_EQ(graph.num_nodes(), static_graph.num_nodes());
+
+    std::set<DeBruijnGraph::node_index> nodes;
+    graph.call_kmers([&](auto node, const std::string &kmer) {
+        auto static_node = static_graph.kmer_to_node(kmer);
+        ASSERT_NE(DeBruijnGraph::npos, static_node);
+        EXPECT_EQ(graph.outdegree(node), static_graph.outdegree(static_node)) << kmer;
+        EXPECT_EQ(graph.indegree(node), static_graph.indegree(static_node)) << kmer;
+        nodes.insert(static_node);
+    });
+    EXPECT_EQ(graph.num_nodes(), nodes.size());
+}
+
+TEST(DBGHashMPHF, IndexKmers) {
+    for (size_t k : { 2, 3, 12, 31, 40, 100 }) {
+        DBGHashFast graph(k);
+        for (const auto &sequence : random_sequences(100, 200)) {
+            graph.add_sequence(sequence);
+        }
+
+        DBGHashMPHF static_graph(graph);
+        EXPECT_EQ(k, static_graph.get_k());
+        check_same_kmers(graph, static_graph);
+    }
+}
+
+TEST(DBGHashMPHF, IndexKmersParallel) {
+    DBGHashFast graph(20);
+    for (const auto &sequence : random_sequences(1000, 200)) {
+        graph.add_sequence(sequence);
+    }
+
+    DBGHashMPHF static_graph(graph, 16, 4);
+    check_same_kmers(graph, static_graph);
+    EXPECT_TRUE(DBGHashMPHF(graph, 16, 1) == static_graph);
+}
+
+TEST(DBGHashMPHF, MapToNodes) {
+    DBGHashFast graph(15);
+    auto sequences = random_sequences(100, 200);
+    for (const auto &sequence : sequences) {
+        graph.add_sequence(sequence);
+    }
+
+    DBGHashMPHF static_graph(graph);
+    for (const auto &sequence : sequences) {
+        std::vector<DeBruijnGraph::node_index> nodes;
+        static_graph.map_to_nodes(sequence, [&](auto node) { nodes.push_back(node); });
+        ASSERT_EQ(sequence.size() - 14, nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            EXPECT_EQ(static_graph.kmer_to_node(sequence.substr(i, 15)), nodes[i]);
+            EXPECT_NE(DeBruijnGraph::npos, nodes[i]);
+        }
+    }
+}
+
+TEST(DBGHashMPHF, FalsePositives) {
+    for (uint8_t fingerprint_bits : { 8, 16 }) {
+        DBGHashFast graph(31);
+        for (const auto &sequence : random_sequences(100, 1000)) {
+            graph.add_sequence(sequence);
+        }
+
+        DBGHashMPHF static_graph(graph, fingerprint_bits);
+        EXPECT_EQ(fingerprint_bits, static_graph.get_fingerprint_bits());
+
+        size_t num_false_positives = 0;
+        size_t num_absent = 0;
+        std::mt19937 gen(1);
+        std::uniform_int_distribution<int> dist(0, 3);
+        for (size_t i = 0; i < 100'000; ++i) {
+            std::string kmer;
+            for (size_t j = 0; j < 31; ++j) {
+                kmer.push_back("ACGT"[dist(gen)]);
+            }
+            if (graph.kmer_to_node(kmer))
+                continue;
+
+            num_absent++;
+            if (static_graph.kmer_to_node(kmer))
+                num_false_positives++;
+        }
+        // 2^-8 ~= 0.004 and 2^-16 ~= 0.00002
+        EXPECT_GT(4. / (1 << fingerprint_bits), 1. * num_false_positives / num_absent);
+    }
+}
+
+#if ! _PROTEIN_GRAPH
+TEST(DBGHashMPHF, MapToNodesCanonical) {
+    DBGHashFast graph(11, DeBruijnGraph::CANONICAL);
+    auto sequences = random_sequences(100, 100);
+    for (const auto &sequence : sequences) {
+        graph.add_sequence(sequence);
+    }
+
+    DBGHashMPHF static_graph(graph);
+    ASSERT_EQ(DeBruijnGraph::CANONICAL, static_graph.get_mode());
+    check_same_kmers(graph, static_graph);
+
+    for (auto sequence : sequences) {
+        std::vector<DeBruijnGraph::node_index> nodes;
+        static_graph.map_to_nodes(sequence, [&](auto node) { nodes.push_back(node); });
+
+        reverse_complement(sequence.begin(), sequence.end());
+        std::vector<DeBruijnGraph::node_index> rev_comp_nodes;
+        static_graph.map_to_nodes(sequence, [&](auto node) { rev_comp_nodes.push_back(node); });
+        std::reverse(rev_comp_nodes.begin(), rev_comp_nodes.end());
+
+        EXPECT_EQ(nodes, rev_comp_nodes);
+    }
+}
+#endif
+
+TEST(DBGHashMPHF, Serialize) {
+    DBGHashFast graph(21);
+    for (const auto &sequence : random_sequences(100, 200)) {
+        graph.add_sequence(sequence);
+    }
+
+    DBGHashMPHF static_graph(graph, 12);
+    static_graph.serialize(test_dump_basename);
+
+    DBGHashMPHF loaded(2);
+    ASSERT_TRUE(loaded.load(test_dump_basename));
+    EXPECT_TRUE(static_graph == loaded);
+    EXPECT_EQ(12u, loaded.get_fingerprint_bits());
+    check_same_kmers(graph, loaded);
+}
+
+} // namespace
@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+#include "sketch/kmer_sketcher.hpp"
+#include "sketch/tensor.hpp"
+
+
+namespace {
+
+using namespace ts;
+
+std::vector<uint8_t> random_sequence(size_t length, uint8_t alphabet_size) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<uint32_t> dis(0, alphabet_size - 1);
+    std::vector<uint8_t> seq(length);
+    for (uint8_t &c : seq) {
+        c = dis(gen);
+    }
+    return seq;
+}
+
+TEST(Tensor, ComputeIntoMatchesCompute) {
+    for (size_t tuple_length : { 1, 3, 6 }) {
+        Tensor<uint8_t> tensor(4, 20, tuple_length, 7);
+        std::vector<double> scratch(tensor.scratch_size());
+
+        for (size_t length : { 6, 10, 31 }) {
+            auto seq = random_sequence(length, 4);
+            auto expected = tensor.compute(seq);
+
+            std::vector<double> sketch(expected.size());
+            tensor.compute_into(seq.data(), seq.size(), sketch.data(), scratch.data());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                EXPECT_NEAR(expected[i], sketch[i], 1e-12);
+            }
+        }
+    }
+}
+
+TEST(Tensor, ShiftSumMatchesScalar) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dis(-1, 1);
+    for (size_t len : { 1, 3, 4, 7, 20, 32, 33, 64 }) {
+        std::vector<double> a(len), b(len);
+        for (size_t i = 0; i < len; ++i) {
+            a[i] = dis(gen);
+            b[i] = dis(gen);
+        }
+        std::vector<float> a_float(a.begin(), a.end());
+        std::vector<float> b_float(b.begin(), b.end());
+
+        for (uint8_t shift = 0; shift < len; ++shift) {
+            std::vector<double> expected = a;
+            Tensor<uint8_t>::shift_sum_inplace_scalar(expected.data(), b.data(), len, shift, 0.3);
+
+            std::vector<double> result = a;
+            Tensor<uint8_t>::shift_sum_inplace(result.data(), b.data(), len, shift, 0.3);
+
+            std::vector<float> result_float = a_float;
+            Tensor<uint8_t>::shift_sum_inplace(result_float.data(), b_float.data(),
+                                               len, shift, 0.3f);
+
+            for (size_t i = 0; i < len; ++i) {
+                EXPECT_NEAR(expected[i], result[i], 1e-12);
+                EXPECT_NEAR(expected[i], result_float[i], 1e-5);
+            }
+        }
+    }
+}
+
+TEST(KmerSketcher, ComputeIntoMatchesWindowSketches) {
+    const uint32_t k = 31;
+    KmerSketcher sketcher(4, 16, 3, k, 3);
+    ASSERT_EQ(sketcher.num_windows() * sketcher.embed_dim(), sketcher.dim());
+
+    auto kmer = random_sequence(k, 4);
+    std::vector<float> sketch(sketcher.dim());
+    std::vector<double> scratch(sketcher.scratch_size());
+
+    for (uint32_t repeat = 0; repeat < sketcher.num_repeats(); ++repeat) {
+        sketcher.compute_into(kmer.data(), repeat, sketch.data(), scratch.data());
+
+        Tensor<uint8_t> tensor(4, 16, 3, repeat);
+        size_t j = 0;
+        for (uint32_t start = 0; start + sketcher.window() <= k; start += sketcher.stride()) {
+            std::vector<uint8_t> window(kmer.begin() + start,
+                                        kmer.begin() + start + sketcher.window());
+            for (double value : tensor.compute(window)) {
+                EXPECT_NEAR(value, sketch[j++], 1e-6);
+            }
+        }
+        EXPECT_EQ(sketcher.dim(), j);
+    }
+}
+
+TEST(KmerSketcher, ComputeAllIntoMatchesComputeInto) {
+    for (uint32_t k : { 20, 31, 55 }) {
+        KmerSketcher sketcher(4, 20, 3, k, 2);
+
+        for (bool with_invalid : { false, true }) {
+            auto seq = random_sequence(150, 4);
+            if (with_invalid) {
+                // characters outside of the alphabet
+                seq[0] = seq[40] = seq[45] = seq[149] = 5;
+            }
+
+            std::vector<float> sketches((seq.size() - k + 1) * sketcher.dim());
+            std::vector<float> window_sketches((seq.size() - sketcher.window() + 1)
+                                                    * sketcher.embed_dim());
+            std::vector<float> expected(sketcher.dim());
+            std::vector<double> scratch(sketcher.sliding_scratch_size());
+
+            for (uint32_t repeat = 0; repeat < sketcher.num_repeats(); ++repeat) {
+                sketcher.compute_all_into(seq.data(), seq.size(), repeat, sketches.data(),
+                                          window_sketches.data(), scratch.data());
+
+                for (size_t i = 0; i + k <= seq.size(); ++i) {
+                    sketcher.compute_into(seq.data() + i, repeat, expected.data(), scratch.data());
+                    for (size_t j = 0; j < sketcher.dim(); ++j) {
+                        ASSERT_NEAR(expected[j], sketches[i * sketcher.dim() + j], 1e-5)
+                            << k << " " << with_invalid << " " << i << " " << j;
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace